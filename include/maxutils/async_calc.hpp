@@ -0,0 +1,143 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef ASYNC_CALC_HPP
+#define ASYNC_CALC_HPP
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "c74_jitter.h"
+#include "jit_matrix_helpers.hpp"
+#include "named_matrix.hpp"
+#include "tracer.hpp"
+
+namespace maxutils {
+    using namespace c74::max;
+
+    // Register as an enum attribute (create_attr<&t_obj::calc_mode>(c)) to let the patch choose.
+    enum class calc_mode {
+        sync,
+        pipelined,
+    };
+
+    // Runs Kernel(x, in_matrix, out_matrix) either directly or on a worker thread with one frame of latency.
+    // In pipelined mode each matrix_calc outputs the previous frame's result straight away, copies the new
+    // input into a staging matrix and hands it to the worker, so the scheduler only pays for two copies and
+    // throughput is bounded by the worker rather than the main thread. The very first pipelined frame has
+    // no result to output and leaves the output matrix untouched.
+    // The kernel reads the object from the worker thread, so attributes it depends on should be copied
+    // somewhere stable (e.g. an attr_schema snapshot) if they can change while it runs.
+    template <typename Object, auto Kernel>
+    class async_matrix_calc {
+    public:
+        async_matrix_calc() : worker{[this] { run(); }} {
+        }
+
+        ~async_matrix_calc() {
+            {
+                std::lock_guard lock{mutex};
+                quit = true;
+            }
+            cv.notify_all();
+            worker.join();
+        }
+
+        async_matrix_calc(const async_matrix_calc &) = delete;
+        async_matrix_calc &operator=(const async_matrix_calc &) = delete;
+
+        // Drop-in body for a MOP's matrix_calc method.
+        t_jit_err calc(Object *x, void *inputs, void *outputs, calc_mode mode) {
+            auto in_matrix = get_matrix_object_from_list(inputs);
+            auto out_matrix = get_matrix_object_from_list(outputs);
+            if (!matrix_pointers_are_valid(in_matrix, out_matrix)) {
+                return JIT_ERR_INVALID_PTR;
+            }
+
+            wait_until_idle();
+
+            if (mode == calc_mode::sync) {
+                has_result = false;
+                MatrixLock lock{in_matrix, out_matrix};
+                trace_scope span{"kernel", "calc"};
+                return Kernel(x, in_matrix, out_matrix);
+            }
+
+            const t_jit_err err = result_err;
+            result_err = JIT_ERR_NONE;
+            {
+                MatrixLock lock{in_matrix, out_matrix};
+                if (has_result) {
+                    trace_scope span{"output", "calc"};
+                    jit_matrix_copy_adapt(out_matrix, (t_object *) result->matrix);
+                }
+                trace_scope span{"stage input", "calc"};
+                t_jit_matrix_info in_info, out_info;
+                jit_object_method(in_matrix, _jit_sym_getinfo, &in_info);
+                jit_object_method(out_matrix, _jit_sym_getinfo, &out_info);
+                if (!staging) {
+                    staging = std::make_unique<NamedMatrix>(&in_info);
+                    result = std::make_unique<NamedMatrix>(&out_info);
+                }
+                jit_matrix_copy_adapt((t_object *) staging->matrix, in_matrix);
+                jit_object_method(result->matrix, _jit_sym_setinfo, &out_info);
+            }
+
+            {
+                std::lock_guard lock{mutex};
+                pending = x;
+            }
+            cv.notify_all();
+            return err;
+        }
+
+        // Blocks until the worker has finished the frame it is on, e.g. before changing what the kernel reads.
+        void wait_until_idle() {
+            std::unique_lock lock{mutex};
+            cv.wait(lock, [this] { return pending == nullptr; });
+        }
+
+    private:
+        void run() {
+            std::unique_lock lock{mutex};
+            for (;;) {
+                cv.wait(lock, [this] { return quit || pending != nullptr; });
+                if (quit) {
+                    return;
+                }
+                Object *x = pending;
+                lock.unlock();
+
+                t_jit_err err;
+                {
+                    auto in_matrix = (t_object *) staging->matrix;
+                    auto out_matrix = (t_object *) result->matrix;
+                    MatrixLock matrix_lock{in_matrix, out_matrix};
+                    trace_scope span{"kernel", "calc"};
+                    err = Kernel(x, in_matrix, out_matrix);
+                }
+
+                lock.lock();
+                result_err = err;
+                has_result = true;
+                pending = nullptr;
+                cv.notify_all();
+            }
+        }
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        Object *pending = nullptr;
+        bool quit = false;
+        bool has_result = false;
+        t_jit_err result_err = JIT_ERR_NONE;
+        std::unique_ptr<NamedMatrix> staging;
+        std::unique_ptr<NamedMatrix> result;
+        std::thread worker;
+    };
+}
+
+#endif //ASYNC_CALC_HPP
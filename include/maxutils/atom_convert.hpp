@@ -0,0 +1,154 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef ATOM_CONVERT_HPP
+#define ATOM_CONVERT_HPP
+
+#include <algorithm>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "c74_jitter.h"
+#include "jit_matrix_view_v2.hpp"
+#include "tracer.hpp"
+#include "detail/cell_convert.hpp"
+
+namespace maxutils {
+    using namespace c74::max;
+
+    // Reusable atom storage for building lists, so emitting a matrix as a list each frame allocates only when
+    // it grows past anything seen before. Keep one per outlet or per object; the span from acquire() is valid
+    // until the next call.
+    class atom_arena {
+    public:
+        std::span<t_atom> acquire(size_t n) {
+            if (atoms.size() < n) {
+                atoms.resize(n);
+            }
+            return {atoms.data(), n};
+        }
+
+        void release() {
+            atoms = {};
+        }
+
+        [[nodiscard]] size_t capacity() const {
+            return atoms.size();
+        }
+
+    private:
+        std::vector<t_atom> atoms;
+    };
+
+    namespace detail {
+        // Integral cells become A_LONG atoms and floating point ones A_FLOAT, written directly rather than
+        // through atom_setlong/atom_setfloat so the loop has no calls or type checks in it.
+        template <typename T>
+        void cells_to_atoms(const T *in, size_t n, t_atom *out) {
+            for (size_t i = 0; i < n; ++i) {
+                if constexpr (std::is_floating_point_v<T>) {
+                    out[i].a_type = A_FLOAT;
+                    out[i].a_w.w_float = static_cast<t_atom_float>(in[i]);
+                } else {
+                    out[i].a_type = A_LONG;
+                    out[i].a_w.w_long = cell_to<t_atom_long>(in[i]);
+                }
+            }
+        }
+
+        template <typename T, typename V>
+        T atom_to_cell(V value) {
+            if constexpr (std::is_same_v<T, char> || std::is_same_v<T, int32_t>) {
+                return cell_from<T>(static_cast<double>(value));
+            } else {
+                return static_cast<T>(value);
+            }
+        }
+
+        // Homogeneous float or long lists take a loop over the one union member; anything else is converted an
+        // atom at a time, symbols and other non-numbers giving 0.
+        template <typename T>
+        void atoms_to_cells(const t_atom *in, size_t n, T *out) {
+            const auto all = [&](short type) {
+                return std::all_of(in, in + n, [type](const t_atom &a) { return a.a_type == type; });
+            };
+            if (all(A_FLOAT)) {
+                for (size_t i = 0; i < n; ++i) {
+                    out[i] = atom_to_cell<T>(in[i].a_w.w_float);
+                }
+            } else if (all(A_LONG)) {
+                for (size_t i = 0; i < n; ++i) {
+                    out[i] = atom_to_cell<T>(in[i].a_w.w_long);
+                }
+            } else {
+                for (size_t i = 0; i < n; ++i) {
+                    switch (in[i].a_type) {
+                        case A_FLOAT: out[i] = atom_to_cell<T>(in[i].a_w.w_float); break;
+                        case A_LONG: out[i] = atom_to_cell<T>(in[i].a_w.w_long); break;
+                        default: out[i] = T{}; break;
+                    }
+                }
+            }
+        }
+
+        template <typename T>
+        long rows_of(matrix_view<T> &view) {
+            return view.dimcount() > 1 ? view.nrows() : 1;
+        }
+    }
+
+    // Writes the row's cells, planes interleaved, into out; returns how many atoms were written (fewer than the
+    // row holds if out is short).
+    template <typename T>
+    size_t to_atoms(const row_view<T> &row, std::span<t_atom> out) {
+        const auto cells = row.as_1d_span();
+        const size_t n = std::min(cells.size(), out.size());
+        detail::cells_to_atoms(cells.data(), n, out.data());
+        return n;
+    }
+
+    // The whole of a 1D or 2D matrix as one list, row after row, in atoms from the arena.
+    template <typename T>
+    std::span<t_atom> to_atoms(matrix_view<T> &view, atom_arena &arena) {
+        if (view.dimcount() > 2) {
+            return {};
+        }
+        trace_scope span{"to_atoms", "matrix"};
+        const long rows = detail::rows_of(view);
+        const size_t row_size = view.ncols() * view.planecount();
+        auto atoms = arena.acquire(rows * row_size);
+        for (long y = 0; y < rows; ++y) {
+            to_atoms(view.row(y), atoms.subspan(y * row_size, row_size));
+        }
+        return atoms;
+    }
+
+    // Fills the row from atoms, planes interleaved; returns how many cells' worth of values were read. Cells
+    // past the end of the list are left alone. Values outside a char or long cell's range saturate.
+    template <typename T>
+    size_t from_atoms(std::span<const t_atom> atoms, const row_view<T> &row) {
+        const auto cells = row.as_1d_span();
+        const size_t n = std::min(cells.size(), atoms.size());
+        detail::atoms_to_cells(atoms.data(), n, cells.data());
+        return n;
+    }
+
+    // Fills a 1D or 2D matrix from a list, row after row, stopping at whichever runs out first.
+    template <typename T>
+    size_t from_atoms(std::span<const t_atom> atoms, matrix_view<T> &view) {
+        if (view.dimcount() > 2) {
+            return 0;
+        }
+        trace_scope span{"from_atoms", "matrix"};
+        const long rows = detail::rows_of(view);
+        size_t read = 0;
+        for (long y = 0; y < rows && read < atoms.size(); ++y) {
+            read += from_atoms(atoms.subspan(read), view.row(y));
+        }
+        return read;
+    }
+}
+
+#endif //ATOM_CONVERT_HPP
@@ -14,12 +14,15 @@
 
 #include "magic_enum.hpp"
 
+#include "attr_schema.hpp"
+
 #include "detail/attr_helpers.hpp"
 #include "detail/reflection.hpp"
 #include "detail/fixed_string.hpp"
 #include "detail/member_pointer.hpp"
 #include "detail/concepts.hpp"
 #include "detail/functors.hpp"
+#include "detail/enum_symbols.hpp"
 
 namespace maxutils {
     using namespace c74::max;
@@ -101,6 +104,9 @@ namespace maxutils {
                 return JIT_ERR_NONE;
             };
             object_method(attr, gensym("setmethod"), gensym("set"), (method) +setter);
+            attr_schema<object_t>::get().set_effect(gensym(name.c_str()), [](void *x) -> t_max_err {
+                return Effect((object_t *) x);
+            });
             return static_cast<Derived &>(*this);
         }
 
@@ -136,6 +142,7 @@ namespace maxutils {
         using Base = AttrBuilderBase<OffsetAttrBuilder, object_t, value_t>;
         OffsetAttrBuilder(t_class *c, std::string custom_name = std::string(detail::get_name<Member>()) )
             : Base(c, custom_name) {
+            attr_schema<object_t>::get().template add<Member>(gensym(this->name.c_str()));
             class_attr_addattr_parse(c, this->name.c_str(), "style", gensym("symbol"), 0, "enum");
             std::string enum_vals;
             for (auto val: magic_enum::enum_names<value_t>()) {
@@ -145,16 +152,22 @@ namespace maxutils {
                 enum_vals += val;
             }
             class_attr_addattr_parse(c, this->name.c_str(), "enumvals", gensym("symbol"), 0, enum_vals.c_str());
+            detail::enum_symbols<value_t>::get();
             object_method(this->attr, gensym("setmethod"), gensym("set"), (method) setter);
             object_method(this->attr, gensym("setmethod"), gensym("get"), (method) getter);
         }
 
         static t_jit_err getter(object_t *x, void *, long *argc, t_atom **argv) {
-            auto value = x->*Member;
-            std::string value_str(magic_enum::enum_name(value));
             char alloc;
             atom_alloc(argc, argv, &alloc);
-            atom_setsym(*argv, gensym(value_str.c_str()));
+            atom_setsym(*argv, detail::enum_symbols<value_t>::get().to_symbol(x->*Member));
+            return JIT_ERR_NONE;
+        }
+
+        static t_jit_err index_getter(object_t *x, void *, long *argc, t_atom **argv) {
+            char alloc;
+            atom_alloc(argc, argv, &alloc);
+            atom_setlong(*argv, magic_enum::enum_index(x->*Member).value_or(0));
             return JIT_ERR_NONE;
         }
 
@@ -163,15 +176,17 @@ namespace maxutils {
                 object_error((t_object *) x, "Expected 1 argument");
                 return JIT_ERR_GENERIC;
             }
-            auto value_str = atom_getsym(argv)->s_name;
-            auto value = magic_enum::enum_cast<value_t>(value_str);
+            auto value = detail::enum_symbols<value_t>::get().from_atom(argv);
             if (!value.has_value()) {
                 std::stringstream error_ss;
-                error_ss << "Invalid value: \"" << value_str << "\". ";
-                error_ss << "Must be one of: ";
-                for (auto val: magic_enum::enum_names<value_t>()) {
-                    error_ss << "\"" << val << "\" ";
+                error_ss << "Invalid value: \"";
+                if (atom_gettype(argv) == A_SYM) {
+                    error_ss << atom_getsym(argv)->s_name;
+                } else {
+                    error_ss << atom_getlong(argv);
                 }
+                error_ss << "\". ";
+                error_ss << "Must be one of: " << detail::enum_symbols<value_t>::describe_values();
 
                 object_error((t_object *) x, error_ss.str().c_str());
                 return JIT_ERR_GENERIC;
@@ -180,10 +195,11 @@ namespace maxutils {
             return JIT_ERR_NONE;
         }
 
-        // OffsetAttrBuilder &style_with_enum_indices() {
-        //     class_attr_addattr_parse(this->c, this->name.c_str(), "style", gensym("symbol"), 0, "enumindex");
-        //     return *this;
-        // }
+        OffsetAttrBuilder &style_with_enum_indices() {
+            class_attr_addattr_parse(this->c, this->name.c_str(), "style", gensym("symbol"), 0, "enumindex");
+            object_method(this->attr, gensym("setmethod"), gensym("get"), (method) index_getter);
+            return *this;
+        }
     };
 
     template <auto Member>
@@ -198,6 +214,7 @@ namespace maxutils {
     public:
         OffsetAttrBuilder(t_class *c, std::string custom_name = std::string(detail::get_name<Member>()) )
             : Base(c, custom_name, detail::member_pointer_info<Member>::offset()) {
+            attr_schema<object_t>::get().template add<Member>(gensym(this->name.c_str()));
             class_attr_addattr_parse(c, this->name.c_str(), "style", gensym("symbol"), 0, "onoff");
         }
 
@@ -232,6 +249,7 @@ namespace maxutils {
     public:
         OffsetAttrBuilder(t_class *c, std::string custom_name = std::string(detail::get_name<Member>()) )
             : Base(c, custom_name, detail::member_pointer_info<Member>::offset()) {
+            attr_schema<object_t>::get().template add<Member>(gensym(this->name.c_str()));
             class_attr_addattr_parse(c, this->name.c_str(), "style", gensym("symbol"), 0, "number");
         }
 
@@ -254,14 +272,15 @@ namespace maxutils {
 
         OffsetAttrBuilder &with_min_max(double min, double max) {
             attr_addfilter_clip(this->attr, min, max, 1, 1);
+            attr_schema<object_t>::get().set_range(gensym(this->name.c_str()), min, max);
             return *this;
         }
 
         template <auto Pred, detail::fixed_string Error>
         requires PurePredicate<decltype(Pred), value_t>
         OffsetAttrBuilder &with_predicate() {
-            auto setter = [](object_t *x, void *, long argc, t_atom *argv) {
-                value_t v = atom_get<value_t>(argv);
+            auto setter = [](object_t *x, void *, long argc, t_atom *argv) -> t_jit_err {
+                value_t v = detail::atom_get<value_t>(argv);
                 if (!Pred(v)) {
                     object_error((t_object *) x, Error);
                     return JIT_ERR_GENERIC;
@@ -270,6 +289,11 @@ namespace maxutils {
                 return JIT_ERR_NONE;
             };
             object_method(this->attr, gensym("setmethod"), gensym("set"), (method) +setter);
+            attr_schema<object_t>::get().set_validator(gensym(this->name.c_str()), [](const std::byte *field) {
+                value_t v;
+                std::memcpy(&v, field, sizeof(v));
+                return static_cast<bool>(Pred(v));
+            }, Error.c_str());
             return *this;
         }
     };
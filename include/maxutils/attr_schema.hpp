@@ -0,0 +1,314 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef ATTR_SCHEMA_HPP
+#define ATTR_SCHEMA_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "ext.h"
+#include "magic_enum.hpp"
+#include "detail/member_pointer.hpp"
+
+namespace maxutils {
+    using namespace c74::max;
+
+    namespace detail {
+        struct attr_schema_entry {
+            t_symbol *name;
+            size_t offset;      // offset of the member in the object struct
+            size_t size;        // size of the member (the whole array for array members)
+            size_t blob_offset; // offset of the field in a packed snapshot
+            double min = 0.0;
+            double max = 0.0;
+            bool clipped = false;
+            bool (*sanitize)(std::byte *field, const attr_schema_entry &entry) = nullptr;
+            bool (*validate)(const std::byte *field) = nullptr; // the attribute's setter predicate, if it has one
+            const char *invalid_message = nullptr;
+            void (*lerp)(std::byte *field, const std::byte *a, const std::byte *b, double t) = nullptr;
+            t_max_err (*effect)(void *x) = nullptr;
+        };
+
+        struct attr_snapshot_header {
+            uint32_t magic;
+            uint32_t schema_hash;
+            uint32_t size;
+            uint32_t reserved;
+        };
+
+        static constexpr uint32_t attr_snapshot_magic = 0x4d554153; // 'MUAS'
+
+        template <typename T>
+        bool sanitize_element(T &value, const attr_schema_entry &entry) {
+            if constexpr (std::is_same_v<T, bool>) {
+                return true;
+            } else if constexpr (std::is_enum_v<T>) {
+                return magic_enum::enum_index(value).has_value();
+            } else if constexpr (std::is_floating_point_v<T>) {
+                if (std::isnan(value)) {
+                    return false;
+                }
+                if (entry.clipped) {
+                    value = std::clamp(value, static_cast<T>(entry.min), static_cast<T>(entry.max));
+                }
+                return true;
+            } else if constexpr (std::is_arithmetic_v<T>) {
+                if (entry.clipped) {
+                    value = std::clamp(value, static_cast<T>(entry.min), static_cast<T>(entry.max));
+                }
+                return true;
+            } else {
+                return true;
+            }
+        }
+
+        template <typename T>
+        bool sanitize_field(std::byte *field, const attr_schema_entry &entry) {
+            using element_t = std::remove_all_extents_t<T>;
+            constexpr size_t count = sizeof(T) / sizeof(element_t);
+            for (size_t i = 0; i < count; ++i) {
+                std::byte *p = field + i * sizeof(element_t);
+                if constexpr (std::is_same_v<element_t, bool>) {
+                    // a snapshot can hold any byte here, normalise it before it is read as a bool
+                    unsigned char raw;
+                    std::memcpy(&raw, p, 1);
+                    const bool value = raw != 0;
+                    std::memcpy(p, &value, sizeof(bool));
+                } else {
+                    element_t value;
+                    std::memcpy(&value, p, sizeof(element_t));
+                    if (!sanitize_element(value, entry)) {
+                        return false;
+                    }
+                    std::memcpy(p, &value, sizeof(element_t));
+                }
+            }
+            return true;
+        }
+
+        template <typename T>
+        void lerp_field(std::byte *field, const std::byte *a, const std::byte *b, double t) {
+            using element_t = std::remove_all_extents_t<T>;
+            constexpr size_t count = sizeof(T) / sizeof(element_t);
+            if constexpr (std::is_arithmetic_v<element_t> && !std::is_same_v<element_t, bool>) {
+                for (size_t i = 0; i < count; ++i) {
+                    element_t va, vb;
+                    std::memcpy(&va, a + i * sizeof(element_t), sizeof(element_t));
+                    std::memcpy(&vb, b + i * sizeof(element_t), sizeof(element_t));
+                    double v = static_cast<double>(va) + (static_cast<double>(vb) - static_cast<double>(va)) * t;
+                    if constexpr (std::is_integral_v<element_t>) {
+                        v = std::round(v);
+                    }
+                    const auto result = static_cast<element_t>(v);
+                    std::memcpy(field + i * sizeof(element_t), &result, sizeof(element_t));
+                }
+            } else {
+                // booleans, enums and symbols can't be blended, so they step half way through
+                std::memcpy(field, t < 0.5 ? a : b, sizeof(T));
+            }
+        }
+
+        inline uint32_t fnv1a(uint32_t hash, const void *data, size_t size) {
+            auto bytes = static_cast<const unsigned char *>(data);
+            for (size_t i = 0; i < size; ++i) {
+                hash ^= bytes[i];
+                hash *= 16777619u;
+            }
+            return hash;
+        }
+    }
+
+    // Per-class description of every offset-backed attribute, filled in by the attribute builders.
+    // Snapshots are packed binary blobs that can be restored (or blended) without going through atoms.
+    template <typename Object>
+    class attr_schema {
+    public:
+        using entry_t = detail::attr_schema_entry;
+        using header_t = detail::attr_snapshot_header;
+
+        static attr_schema &get() {
+            static attr_schema instance;
+            return instance;
+        }
+
+        template <auto member_ptr>
+        void add(t_symbol *name) {
+            using value_t = detail::member_pointer_value_type_t<member_ptr>;
+            static_assert(std::is_trivially_copyable_v<value_t>, "Snapshot attributes must be trivially copyable");
+            if (find(name)) {
+                return;
+            }
+            entries_.push_back({
+                .name = name,
+                .offset = detail::member_pointer_info<member_ptr>::offset(),
+                .size = sizeof(value_t),
+                .blob_offset = size_,
+                .sanitize = &detail::sanitize_field<value_t>,
+                .lerp = &detail::lerp_field<value_t>,
+            });
+            size_ += sizeof(value_t);
+
+            const uint32_t size = sizeof(value_t);
+            hash_ = detail::fnv1a(hash_, name->s_name, std::strlen(name->s_name));
+            hash_ = detail::fnv1a(hash_, &size, sizeof(size));
+        }
+
+        // Sizes the schema for attributes about to be added, count of them holding bytes between them, so
+        // registering them doesn't grow anything one attribute at a time.
+        void reserve(size_t count, size_t bytes) {
+            entries_.reserve(entries_.size() + count);
+            scratch(size_ + bytes);
+        }
+
+        void set_range(t_symbol *name, double min, double max) {
+            if (auto entry = find(name)) {
+                entry->min = min;
+                entry->max = max;
+                entry->clipped = true;
+            }
+        }
+
+        void set_effect(t_symbol *name, t_max_err (*effect)(void *)) {
+            if (auto entry = find(name)) {
+                entry->effect = effect;
+            }
+        }
+
+        // Snapshots are held to the same predicate as the attribute's setter.
+        void set_validator(t_symbol *name, bool (*validate)(const std::byte *), const char *message) {
+            if (auto entry = find(name)) {
+                entry->validate = validate;
+                entry->invalid_message = message;
+            }
+        }
+
+        [[nodiscard]] size_t snapshot_size() const {
+            return sizeof(header_t) + size_;
+        }
+
+        [[nodiscard]] const std::vector<entry_t> &entries() const {
+            return entries_;
+        }
+
+        t_max_err snapshot(const Object *x, std::span<std::byte> blob) const {
+            if (blob.size() < snapshot_size()) {
+                return MAX_ERR_GENERIC;
+            }
+            const header_t header{detail::attr_snapshot_magic, hash_, static_cast<uint32_t>(size_), 0};
+            std::memcpy(blob.data(), &header, sizeof(header));
+            std::byte *fields = blob.data() + sizeof(header_t);
+            const auto *object = reinterpret_cast<const std::byte *>(x);
+            for (const auto &entry: entries_) {
+                std::memcpy(fields + entry.blob_offset, object + entry.offset, entry.size);
+            }
+            return MAX_ERR_NONE;
+        }
+
+        std::vector<std::byte> snapshot(const Object *x) const {
+            std::vector<std::byte> blob(snapshot_size());
+            snapshot(x, blob);
+            return blob;
+        }
+
+        // Restores every attribute in one go: the blob is validated (and clipped) as a whole before anything
+        // is written, and effects only run for attributes whose value actually changed.
+        t_max_err restore(Object *x, std::span<const std::byte> blob) {
+            if (!validate_header(x, blob)) {
+                return MAX_ERR_GENERIC;
+            }
+            auto fields = scratch(size_);
+            std::memcpy(fields.data(), blob.data() + sizeof(header_t), size_);
+            return commit(x, fields);
+        }
+
+        // Blends numeric attributes linearly between two snapshots, everything else switches at t = 0.5.
+        t_max_err interpolate(Object *x, std::span<const std::byte> a, std::span<const std::byte> b, double t) {
+            if (!validate_header(x, a) || !validate_header(x, b)) {
+                return MAX_ERR_GENERIC;
+            }
+            const std::byte *fields_a = a.data() + sizeof(header_t);
+            const std::byte *fields_b = b.data() + sizeof(header_t);
+            auto fields = scratch(size_);
+            for (const auto &entry: entries_) {
+                entry.lerp(fields.data() + entry.blob_offset, fields_a + entry.blob_offset, fields_b + entry.blob_offset, t);
+            }
+            return commit(x, fields);
+        }
+
+    private:
+        attr_schema() = default;
+
+        entry_t *find(t_symbol *name) {
+            auto it = std::find_if(entries_.begin(), entries_.end(), [name](const entry_t &e) { return e.name == name; });
+            return it == entries_.end() ? nullptr : &*it;
+        }
+
+        bool validate_header(Object *x, std::span<const std::byte> blob) const {
+            header_t header;
+            if (blob.size() < sizeof(header)) {
+                object_error((t_object *) x, "Invalid snapshot: too small");
+                return false;
+            }
+            std::memcpy(&header, blob.data(), sizeof(header));
+            if (header.magic != detail::attr_snapshot_magic || header.schema_hash != hash_ || header.size != size_
+                || blob.size() < snapshot_size()) {
+                object_error((t_object *) x, "Invalid snapshot: attribute layout doesn't match");
+                return false;
+            }
+            return true;
+        }
+
+        // The schema is shared by every instance of the class, which can restore on different threads at once, so
+        // the fields are staged in a per-thread buffer.
+        static std::span<std::byte> scratch(size_t size) {
+            static thread_local std::vector<std::byte> buffer;
+            if (buffer.size() < size) {
+                buffer.resize(size);
+            }
+            return {buffer.data(), size};
+        }
+
+        t_max_err commit(Object *x, std::span<std::byte> fields) {
+            for (const auto &entry: entries_) {
+                std::byte *field = fields.data() + entry.blob_offset;
+                if (!entry.sanitize(field, entry)) {
+                    object_error((t_object *) x, "Invalid snapshot: bad value for attribute \"%s\"", entry.name->s_name);
+                    return MAX_ERR_GENERIC;
+                }
+                if (entry.validate && !entry.validate(field)) {
+                    object_error((t_object *) x, "Invalid snapshot: %s", entry.invalid_message);
+                    return MAX_ERR_GENERIC;
+                }
+            }
+            auto *object = reinterpret_cast<std::byte *>(x);
+            t_max_err result = MAX_ERR_NONE;
+            for (const auto &entry: entries_) {
+                const std::byte *field = fields.data() + entry.blob_offset;
+                if (std::memcmp(object + entry.offset, field, entry.size) == 0) {
+                    continue;
+                }
+                std::memcpy(object + entry.offset, field, entry.size);
+                if (entry.effect) {
+                    if (auto err = entry.effect(x)) {
+                        result = err;
+                    }
+                }
+            }
+            return result;
+        }
+
+        std::vector<entry_t> entries_;
+        size_t size_ = 0;
+        uint32_t hash_ = 2166136261u;
+    };
+}
+
+#endif //ATTR_SCHEMA_HPP
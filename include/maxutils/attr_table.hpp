@@ -0,0 +1,145 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef ATTR_TABLE_HPP
+#define ATTR_TABLE_HPP
+
+#include <string_view>
+#include <type_traits>
+
+#include "ext.h"
+#include "ext_obex.h"
+#include "magic_enum.hpp"
+
+#include "attributes.hpp"
+#include "attr_schema.hpp"
+#include "detail/attr_helpers.hpp"
+#include "detail/fixed_string.hpp"
+#include "detail/member_pointer.hpp"
+#include "detail/reflection.hpp"
+
+namespace maxutils {
+    using namespace c74::max;
+
+    namespace detail {
+        template <size_t N>
+        constexpr fixed_string<N + 1> to_fixed_string(std::string_view sv) {
+            fixed_string<N + 1> s{};
+            for (size_t i = 0; i < N; ++i) {
+                s.data[i] = sv[i];
+            }
+            return s;
+        }
+
+        template <size_t N>
+        constexpr fixed_string<N> to_label(const fixed_string<N> &name) {
+            fixed_string<N> label = name;
+            for (size_t i = 0; i + 1 < N; ++i) {
+                if (label.data[i] == '_') {
+                    label.data[i] = ' ';
+                }
+            }
+            for (size_t i = 0; i + 1 < N; ++i) {
+                if ((i == 0 || label.data[i - 1] == ' ') && label.data[i] >= 'a' && label.data[i] <= 'z') {
+                    label.data[i] = static_cast<char>(label.data[i] - 'a' + 'A');
+                }
+            }
+            return label;
+        }
+
+        template <typename E>
+        constexpr size_t enum_vals_length() {
+            size_t length = 0;
+            for (auto val: magic_enum::enum_names<E>()) {
+                length += val.size() + 1;
+            }
+            return length == 0 ? 1 : length;
+        }
+
+        template <typename E>
+        constexpr auto to_enum_vals() {
+            fixed_string<enum_vals_length<E>()> vals{};
+            size_t i = 0;
+            for (auto val: magic_enum::enum_names<E>()) {
+                if (i != 0) {
+                    vals.data[i++] = ' ';
+                }
+                for (char ch: val) {
+                    vals.data[i++] = ch;
+                }
+            }
+            return vals;
+        }
+
+        template <typename T>
+        constexpr const char *attr_style() {
+            if constexpr (std::is_same_v<T, bool>) {
+                return "onoff";
+            } else if constexpr (std::is_enum_v<T>) {
+                return "enum";
+            } else if constexpr (std::is_arithmetic_v<std::remove_all_extents_t<T>>) {
+                return "number";
+            } else {
+                return nullptr;
+            }
+        }
+
+        // Everything an attribute needs as a string, computed once at compile time.
+        template <auto member_ptr>
+        struct attr_table_entry {
+            using object_t = member_pointer_object_type_t<member_ptr>;
+            using value_t = member_pointer_value_type_t<member_ptr>;
+
+            static constexpr std::string_view name_view = get_name<member_ptr>();
+            static constexpr auto name = to_fixed_string<name_view.size()>(name_view);
+            static constexpr auto label = to_label(name);
+            static constexpr const char *style = attr_style<value_t>();
+
+            static void add(t_class *c, t_symbol *sym_symbol) {
+                t_symbol *type = type_to_symbol<value_t>();
+                const long offset = member_pointer_info<member_ptr>::offset();
+                t_object *attr;
+                if constexpr (std::is_array_v<value_t>) {
+                    attr = attr_offset_array_new(name.c_str(), type, std::extent_v<value_t>, 0, nullptr, nullptr, 0, offset);
+                } else {
+                    attr = attr_offset_new(name.c_str(), type, 0, nullptr, nullptr, offset);
+                }
+                class_addattr(c, attr);
+                class_attr_addattr_format(c, name.c_str(), "label", sym_symbol, 0, "s", gensym_tr(label.c_str()));
+                if constexpr (style != nullptr) {
+                    class_attr_addattr_parse(c, name.c_str(), "style", sym_symbol, 0, style);
+                }
+                if constexpr (std::is_enum_v<value_t>) {
+                    static constexpr auto enum_vals = to_enum_vals<value_t>();
+                    class_attr_addattr_parse(c, name.c_str(), "enumvals", sym_symbol, 0, enum_vals.c_str());
+                    enum_symbols<value_t>::get();
+                    object_method(attr, gensym("setmethod"), gensym("set"), (method) &enum_attr_accessors<member_ptr>::setter);
+                    object_method(attr, gensym("setmethod"), gensym("get"), (method) &enum_attr_accessors<member_ptr>::getter);
+                }
+                attr_schema<object_t>::get().template add<member_ptr>(gensym(name.c_str()));
+            }
+        };
+    }
+
+    // Declarative alternative to a run of create_attr calls, e.g.
+    //     maxutils::attrs<&t_obj::gain, &t_obj::mode, &t_obj::bypass>::register_all(c);
+    // Names, labels, styles and enumvals are all baked in at compile time.
+    template <auto member_ptr, auto ...member_ptrs>
+    struct attrs {
+        using object_t = detail::member_pointer_object_type_t<member_ptr>;
+        static_assert((std::is_same_v<object_t, detail::member_pointer_object_type_t<member_ptrs>> && ...),
+                      "All attributes must belong to the same object");
+
+        static void register_all(t_class *c) {
+            t_symbol *sym_symbol = gensym("symbol");
+            attr_schema<object_t>::get().reserve(1 + sizeof...(member_ptrs),
+                                                 (sizeof(detail::member_pointer_value_type_t<member_ptr>) + ...
+                                                  + sizeof(detail::member_pointer_value_type_t<member_ptrs>)));
+            detail::attr_table_entry<member_ptr>::add(c, sym_symbol);
+            (detail::attr_table_entry<member_ptrs>::add(c, sym_symbol), ...);
+        }
+    };
+}
+
+#endif //ATTR_TABLE_HPP
@@ -10,6 +10,8 @@
 #include "detail/member_pointer.hpp"
 #include "detail/functors.hpp"
 #include "detail/reflection.hpp"
+#include "detail/enum_symbols.hpp"
+#include "attr_schema.hpp"
 #include "magic_enum.hpp"
 #include "ext_obex.h"
 
@@ -85,6 +87,46 @@ namespace maxutils {
             t_object *attr;
         };
 
+        template <auto member_ptr>
+        struct enum_attr_accessors {
+            using object_t = member_pointer_object_type_t<member_ptr>;
+            using value_t = member_pointer_value_type_t<member_ptr>;
+
+            static err_t getter(object_t *x, void *, long *argc, t_atom **argv) {
+                char alloc;
+                atom_alloc(argc, argv, &alloc);
+                atom_setsym(*argv, enum_symbols<value_t>::get().to_symbol(x->*member_ptr));
+                return 0;
+            }
+
+            static err_t index_getter(object_t *x, void *, long *argc, t_atom **argv) {
+                char alloc;
+                atom_alloc(argc, argv, &alloc);
+                atom_setlong(*argv, magic_enum::enum_index(x->*member_ptr).value_or(0));
+                return 0;
+            }
+
+            static err_t setter(object_t *x, void *, long argc, t_atom *argv) {
+                if (argc != 1) {
+                    object_error((t_object *) x, "Expected 1 argument, got %ld", argc);
+                    return MAX_ERR_GENERIC;
+                }
+                auto value = enum_symbols<value_t>::get().from_atom(argv);
+                if (!value) {
+                    if (atom_gettype(argv) == A_SYM) {
+                        object_error((t_object *) x, "Invalid value: %s. Must be one of: %s",
+                                     atom_getsym(argv)->s_name, enum_symbols<value_t>::describe_values().c_str());
+                    } else {
+                        object_error((t_object *) x, "Invalid index: %ld. Must be between 0 and %ld",
+                                     (long) atom_getlong(argv), (long) enum_symbols<value_t>::count - 1);
+                    }
+                    return MAX_ERR_GENERIC;
+                }
+                x->*member_ptr = value.value_or(value_t{});
+                return MAX_ERR_NONE;
+            }
+        };
+
         template <auto member_ptr>
         class offset_attr_builder : public attr_builder<offset_attr_builder<member_ptr>> {
             using object_t = member_pointer_object_type_t<member_ptr>;
@@ -104,6 +146,9 @@ namespace maxutils {
                     }
                 };
                 object_method(this->attr, gensym("setmethod"), gensym("set"), (method) +setter_with_effect);
+                attr_schema<object_t>::get().set_effect(gensym(this->name.c_str()), [](void *x) -> t_max_err {
+                    return std::invoke(s_effect, (object_t *) x);
+                });
                 return *this;
             }
 
@@ -113,7 +158,7 @@ namespace maxutils {
                 static const auto s_pred = pred;
                 static const auto s_message = message;
 
-                auto setter_with_predicate = [](object_t *x, void *attr, long argc, t_atom *argv) {
+                auto setter_with_predicate = [](object_t *x, void *attr, long argc, t_atom *argv) -> err_t {
                     auto value = atom_get<value_t>(argv);
                     if (std::invoke(s_pred, value)) {
                         return setter(x, attr, argc, argv);
@@ -124,10 +169,23 @@ namespace maxutils {
                 };
 
                 object_method(this->attr, gensym("setmethod"), gensym("set"), (method) +setter_with_predicate);
+                attr_schema<object_t>::get().set_validator(gensym(this->name.c_str()), [](const std::byte *field) {
+                    value_t value;
+                    std::memcpy(&value, field, sizeof(value));
+                    return static_cast<bool>(std::invoke(s_pred, value));
+                }, s_message);
                 return *this;
             }
             offset_attr_builder &with_min_max(double min, double max) requires (std::is_arithmetic_v<value_t>) {
                 attr_addfilter_clip(this->attr, min, max, 1, 1);
+                attr_schema<object_t>::get().set_range(gensym(this->name.c_str()), min, max);
+                return *this;
+            }
+
+            // Enum specific attributes
+            offset_attr_builder &with_enum_indices() requires (std::is_enum_v<value_t>) {
+                class_attr_addattr_parse(this->c, this->name.c_str(), "style", gensym("symbol"), 0, "enumindex");
+                object_method(this->attr, gensym("setmethod"), gensym("get"), (method) &enum_attr_accessors<member_ptr>::index_getter);
                 return *this;
             }
         protected:
@@ -138,13 +196,8 @@ namespace maxutils {
                 atom_set(*argv, value);
                 return 0;
             }
-            static err_t getter(object_t *x, void *, long *argc, t_atom **argv) requires (std::is_enum_v<value_t>) {
-                value_t value = x->*member_ptr;
-                std::string value_str(magic_enum::enum_name(value));
-                char alloc;
-                atom_alloc(argc, argv, &alloc);
-                atom_setsym(*argv, gensym(value_str.c_str()));
-                return 0;
+            static err_t getter(object_t *x, void *attr, long *argc, t_atom **argv) requires (std::is_enum_v<value_t>) {
+                return enum_attr_accessors<member_ptr>::getter(x, attr, argc, argv);
             }
             static err_t setter(object_t *x, void *, long argc, t_atom *argv) requires (!std::is_enum_v<value_t>) {
                 if (argc != 1) {
@@ -154,31 +207,15 @@ namespace maxutils {
                 x->*member_ptr = atom_get<value_t>(argv);
                 return 0;
             }
-            static err_t setter(object_t *x, void *, long argc, t_atom *argv) requires (std::is_enum_v<value_t>) {
-                if (argc != 1) {
-                    object_error((t_object *) x, "Expected 1 argument, got %ld", argc);
-                    return MAX_ERR_GENERIC;
-                }
-                auto value = magic_enum::enum_cast<value_t>(atom_getsym(argv)->s_name);
-                if (!value) {
-                    std::string error_string = "Invalid value: " + std::string(atom_getsym(argv)->s_name) + ". ";
-                    error_string += "Must be one of: ";
-                    for (auto &val : magic_enum::enum_names<value_t>()) {
-                        error_string += "\"";
-                        error_string += val;
-                        error_string += "\" ";
-                    }
-                    object_error((t_object *) x, error_string.c_str());
-                    return MAX_ERR_GENERIC;
-                }
-                x->*member_ptr = value.value_or(value_t{});
-                return MAX_ERR_NONE;
+            static err_t setter(object_t *x, void *attr, long argc, t_atom *argv) requires (std::is_enum_v<value_t>) {
+                return enum_attr_accessors<member_ptr>::setter(x, attr, argc, argv);
             }
         };
 
         template <auto member_ptr>
         offset_attr_builder<member_ptr>::offset_attr_builder(t_class *c, std::string name)
             : attr_builder<offset_attr_builder>(c, name, type_to_symbol<value_t>(), member_pointer_info<member_ptr>::offset()) {
+            attr_schema<object_t>::get().template add<member_ptr>(gensym(this->name.c_str()));
 
             if constexpr (std::is_enum_v<value_t>) {
                 class_attr_addattr_parse(c, this->name.c_str(), "style", gensym("symbol"), 0, "enum");
@@ -190,8 +227,9 @@ namespace maxutils {
                     enum_vals += val;
                 }
                 class_attr_addattr_parse(c, this->name.c_str(), "enumvals", gensym("symbol"), 0, enum_vals.c_str());
-                object_method(this->attr, gensym("setmethod"), gensym("set"), (method) &setter);
-                object_method(this->attr, gensym("setmethod"), gensym("get"), (method) &getter);
+                enum_symbols<value_t>::get();
+                object_method(this->attr, gensym("setmethod"), gensym("set"), (method) &enum_attr_accessors<member_ptr>::setter);
+                object_method(this->attr, gensym("setmethod"), gensym("get"), (method) &enum_attr_accessors<member_ptr>::getter);
             }
 
             if constexpr (std::is_same_v<value_t, bool>) {
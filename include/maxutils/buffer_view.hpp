@@ -0,0 +1,344 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef BUFFER_VIEW_HPP
+#define BUFFER_VIEW_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+#include "c74_jitter.h"
+#include "ext_buffer.h"
+#include "jit_matrix_view_v2.hpp"
+#include "tracer.hpp"
+#include "detail/cell_convert.hpp"
+#include "detail/simd.hpp"
+
+namespace maxutils {
+    using namespace c74::max;
+
+    // Owns a buffer_ref to a named buffer~. Forward the object's notify method to notify() so the reference
+    // follows the buffer being freed and recreated.
+    class buffer_reference {
+    public:
+        buffer_reference(t_object *owner, t_symbol *name) : ref{buffer_ref_new(owner, name)} {
+        }
+
+        buffer_reference(const buffer_reference &) = delete;
+        buffer_reference &operator=(const buffer_reference &) = delete;
+
+        ~buffer_reference() {
+            object_free(ref);
+        }
+
+        void set(t_symbol *name) {
+            buffer_ref_set(ref, name);
+        }
+
+        [[nodiscard]] bool exists() const {
+            return buffer_ref_exists(ref) != 0;
+        }
+
+        t_max_err notify(t_symbol *s, t_symbol *msg, void *sender, void *data) {
+            return buffer_ref_notify(ref, s, msg, sender, data);
+        }
+
+        [[nodiscard]] t_buffer_ref *get() const {
+            return ref;
+        }
+
+    private:
+        t_buffer_ref *ref;
+    };
+
+    // The samples of a buffer~, locked for as long as the view lives, so keep it to the copy or kernel that
+    // needs them. Samples are interleaved floats: frame i is channels() consecutive samples. Invalid (false)
+    // when the buffer doesn't exist or can't be locked.
+    class buffer_view {
+    public:
+        explicit buffer_view(const buffer_reference &ref) : buffer_view(buffer_ref_getobject(ref.get())) {
+        }
+
+        explicit buffer_view(t_buffer_obj *buffer) : buffer{buffer} {
+            if (!buffer) {
+                return;
+            }
+            trace_scope span{"locksamples", "buffer"};
+            samples = buffer_locksamples(buffer);
+            if (samples) {
+                nframes = static_cast<long>(buffer_getframecount(buffer));
+                nchannels = static_cast<long>(buffer_getchannelcount(buffer));
+                rate = static_cast<double>(buffer_getsamplerate(buffer));
+            }
+        }
+
+        buffer_view(const buffer_view &) = delete;
+        buffer_view &operator=(const buffer_view &) = delete;
+
+        ~buffer_view() {
+            if (samples) {
+                if (dirty) {
+                    buffer_setdirty(buffer);
+                }
+                buffer_unlocksamples(buffer);
+            }
+        }
+
+        explicit operator bool() const {
+            return samples != nullptr;
+        }
+
+        [[nodiscard]] long frames() const {
+            return nframes;
+        }
+
+        [[nodiscard]] long channels() const {
+            return nchannels;
+        }
+
+        [[nodiscard]] double samplerate() const {
+            return rate;
+        }
+
+        [[nodiscard]] std::span<float> data() {
+            return {samples, static_cast<size_t>(nframes * nchannels)};
+        }
+
+        [[nodiscard]] std::span<float> frame(long i) {
+            return {samples + i * nchannels, static_cast<size_t>(nchannels)};
+        }
+
+        float &at(long frame, long channel) {
+            return samples[frame * nchannels + channel];
+        }
+
+        // Tells the buffer~ its contents changed when the view is released.
+        void mark_dirty() {
+            dirty = true;
+        }
+
+    private:
+        t_buffer_obj *buffer;
+        float *samples = nullptr;
+        long nframes = 0;
+        long nchannels = 0;
+        double rate = 0.0;
+        bool dirty = false;
+    };
+
+    namespace detail {
+        // Audio is [-1, 1]; char cells map that onto [0, 255], everything else keeps the sample value.
+        template <typename T>
+        T sample_to_cell(float s) {
+            if constexpr (std::is_same_v<T, char>) {
+                return cell_from<char>((s + 1.0f) * 127.5f);
+            } else {
+                return cell_from<T>(s);
+            }
+        }
+
+        template <typename T>
+        float cell_to_sample(T c) {
+            if constexpr (std::is_same_v<T, char>) {
+                return cell_to<float>(c) / 127.5f - 1.0f;
+            } else {
+                return static_cast<float>(c);
+            }
+        }
+
+        // n frames of N interleaved channels to N channel rows, four frames per step (and back).
+        template <size_t N>
+        void deinterleave(const float *in, long n, float *const *out) {
+            long i = 0;
+            for (; i + 4 <= n; i += 4) {
+                f32x4 v[N];
+                load_deinterleaved<N>(in + i * N, v);
+                for (size_t c = 0; c < N; ++c) {
+                    v[c].store(out[c] + i);
+                }
+            }
+            for (; i < n; ++i) {
+                for (size_t c = 0; c < N; ++c) {
+                    out[c][i] = in[i * N + c];
+                }
+            }
+        }
+
+        template <size_t N>
+        void interleave(const float *const *in, long n, float *out) {
+            long i = 0;
+            for (; i + 4 <= n; i += 4) {
+                f32x4 v[N];
+                for (size_t c = 0; c < N; ++c) {
+                    v[c] = f32x4::load(in[c] + i);
+                }
+                store_interleaved<N>(out + i * N, v);
+            }
+            for (; i < n; ++i) {
+                for (size_t c = 0; c < N; ++c) {
+                    out[i * N + c] = in[c][i];
+                }
+            }
+        }
+
+        // Planar matrices are channel rows: 1 plane, frames along dim 0 and a row per channel. Anything else
+        // with a plane per channel is interleaved, frames running along its rows one after another.
+        template <typename T>
+        t_jit_err buffer_layout(matrix_view<T> &m, long channels, bool &planar) {
+            if (m.dimcount() > 2) {
+                return JIT_ERR_MISMATCH_DIM;
+            }
+            planar = channels > 1 && m.planecount() == 1 && m.dimcount() == 2 && m.nrows() == channels;
+            if (!planar && static_cast<long>(m.planecount()) != channels) {
+                return JIT_ERR_MISMATCH_PLANE;
+            }
+            return JIT_ERR_NONE;
+        }
+
+        template <typename T>
+        void buffer_to_rows(const float *samples, long channels, long n, matrix_view<T> &dst) {
+            if constexpr (std::is_same_v<T, float>) {
+                if (channels <= 4) {
+                    float *rows[4];
+                    for (long c = 0; c < channels; ++c) {
+                        rows[c] = dst.row(c).as_1d_span().data();
+                    }
+                    switch (channels) {
+                        case 2: deinterleave<2>(samples, n, rows); return;
+                        case 3: deinterleave<3>(samples, n, rows); return;
+                        case 4: deinterleave<4>(samples, n, rows); return;
+                        default: break;
+                    }
+                }
+            }
+            for (long c = 0; c < channels; ++c) {
+                T *out = dst.row(c).as_1d_span().data();
+                for (long i = 0; i < n; ++i) {
+                    out[i] = sample_to_cell<T>(samples[i * channels + c]);
+                }
+            }
+        }
+
+        template <typename T>
+        void rows_to_buffer(matrix_view<T> &src, long channels, long n, float *samples) {
+            if constexpr (std::is_same_v<T, float>) {
+                if (channels <= 4) {
+                    const float *rows[4];
+                    for (long c = 0; c < channels; ++c) {
+                        rows[c] = src.row(c).as_1d_span().data();
+                    }
+                    switch (channels) {
+                        case 2: interleave<2>(rows, n, samples); return;
+                        case 3: interleave<3>(rows, n, samples); return;
+                        case 4: interleave<4>(rows, n, samples); return;
+                        default: break;
+                    }
+                }
+            }
+            for (long c = 0; c < channels; ++c) {
+                const T *in = src.row(c).as_1d_span().data();
+                for (long i = 0; i < n; ++i) {
+                    samples[i * channels + c] = cell_to_sample(in[i]);
+                }
+            }
+        }
+    }
+
+    // Copies frames from start_frame on into dst, converting to its type (char maps [-1, 1] onto [0, 255]).
+    // dst is interleaved (a plane per channel, frames along its rows) or planar (1 plane, a row per channel).
+    // Cells past the end of the buffer are zeroed. Only float32 is fast: it's a memcpy, or SIMD deinterleaving
+    // for planar dst of up to 4 channels. char, long and float64 convert a sample at a time in a scalar loop.
+    template <typename T>
+    t_jit_err buffer_to_matrix(buffer_view &src, matrix_view<T> &dst, long start_frame = 0) {
+        if (!src) {
+            return JIT_ERR_DATA_UNAVAILABLE;
+        }
+        if (start_frame < 0) {
+            return JIT_ERR_INVALID_INPUT;
+        }
+        bool planar;
+        if (auto err = detail::buffer_layout(dst, src.channels(), planar)) {
+            return err;
+        }
+        trace_scope span{"buffer_to_matrix", "buffer"};
+        const long channels = src.channels(), cols = dst.ncols();
+        auto available = [&](long frame) { return std::clamp(src.frames() - frame, 0l, cols); };
+        if (planar) {
+            const long n = available(start_frame);
+            // past the end of the buffer there is nothing to read, and no valid pointer to read it from
+            if (n > 0) {
+                detail::buffer_to_rows(src.data().data() + start_frame * channels, channels, n, dst);
+            }
+            for (long c = 0; c < channels; ++c) {
+                auto row = dst.row(c).as_1d_span();
+                std::fill(row.begin() + n, row.end(), T{});
+            }
+            return JIT_ERR_NONE;
+        }
+        const long rows = dst.dimcount() > 1 ? dst.nrows() : 1;
+        for (long y = 0; y < rows; ++y) {
+            const long frame = start_frame + y * cols, n = available(frame) * channels;
+            auto out = dst.row(y).as_1d_span();
+            if (n > 0) {
+                const float *in = src.data().data() + frame * channels;
+                if constexpr (std::is_same_v<T, float>) {
+                    std::memcpy(out.data(), in, n * sizeof(float));
+                } else {
+                    for (long i = 0; i < n; ++i) {
+                        out[i] = detail::sample_to_cell<T>(in[i]);
+                    }
+                }
+            }
+            std::fill(out.begin() + n, out.end(), T{});
+        }
+        return JIT_ERR_NONE;
+    }
+
+    // The inverse: writes src's frames into the buffer from start_frame on, dropping any past its end, and
+    // marks it dirty. As above, only float32 avoids the scalar conversion loop.
+    template <typename T>
+    t_jit_err matrix_to_buffer(matrix_view<T> &src, buffer_view &dst, long start_frame = 0) {
+        if (!dst) {
+            return JIT_ERR_DATA_UNAVAILABLE;
+        }
+        if (start_frame < 0) {
+            return JIT_ERR_INVALID_INPUT;
+        }
+        bool planar;
+        if (auto err = detail::buffer_layout(src, dst.channels(), planar)) {
+            return err;
+        }
+        trace_scope span{"matrix_to_buffer", "buffer"};
+        const long channels = dst.channels(), cols = src.ncols();
+        auto available = [&](long frame) { return std::clamp(dst.frames() - frame, 0l, cols); };
+        dst.mark_dirty();
+        if (planar) {
+            if (const long n = available(start_frame); n > 0) {
+                detail::rows_to_buffer(src, channels, n, dst.data().data() + start_frame * channels);
+            }
+            return JIT_ERR_NONE;
+        }
+        const long rows = src.dimcount() > 1 ? src.nrows() : 1;
+        for (long y = 0; y < rows; ++y) {
+            const long frame = start_frame + y * cols, n = available(frame) * channels;
+            if (n == 0) {
+                break;
+            }
+            const T *in = src.row(y).as_1d_span().data();
+            float *out = dst.data().data() + frame * channels;
+            if constexpr (std::is_same_v<T, float>) {
+                std::memcpy(out, in, n * sizeof(float));
+            } else {
+                for (long i = 0; i < n; ++i) {
+                    out[i] = detail::cell_to_sample(in[i]);
+                }
+            }
+        }
+        return JIT_ERR_NONE;
+    }
+}
+
+#endif //BUFFER_VIEW_HPP
@@ -0,0 +1,449 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef COLORSPACE_HPP
+#define COLORSPACE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+#include "c74_jitter.h"
+#include "jit_matrix_view_v2.hpp"
+#include "tracer.hpp"
+#include "detail/cell_convert.hpp"
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+
+namespace maxutils {
+    using namespace c74::max;
+
+    // All channels are normalised to [0, 1] so char and float32 matrices hold the same values (x 255):
+    //   yuv  BT.601 full range (JPEG), U and V offset by 0.5
+    //   hsv  hue as a fraction of a turn
+    //   lab  CIE L*a*b* from sRGB under D65, as L / 100 and (a + 128) / 255, (b + 128) / 255
+    //   grey BT.601 luma
+    // Matrices are read by planecount: 4 is Jitter's ARGB with the channels in planes 1-3, 3 is channels only,
+    // and 1 is grey.
+    enum class color_space {
+        rgb,
+        grey,
+        yuv,
+        hsv,
+        lab,
+    };
+
+    // One plane of a matrix, for converting to or from planar layouts (e.g. a separate 1-plane matrix per
+    // channel).
+    template <typename T>
+    class plane_view {
+    public:
+        plane_view(matrix_view<T> matrix, long plane) : view{matrix}, index{plane} {
+            assert(plane >= 0 && plane < static_cast<long>(view.planecount()));
+        }
+
+        [[nodiscard]] matrix_view<T> &matrix() {
+            return view;
+        }
+
+        [[nodiscard]] long plane() const {
+            return index;
+        }
+
+    private:
+        matrix_view<T> view;
+        long index;
+    };
+
+    namespace detail {
+        constexpr long color_block = 64;
+
+        // Channels 0-2 and alpha (3) of one row, each with its own stride, so interleaved and planar layouts
+        // go through the same kernels. A null channel isn't read or written.
+        template <typename T>
+        struct channel_row {
+            T *c[4] = {};
+            long stride[4] = {};
+        };
+
+        using color_block_data = float[4][color_block];
+
+        inline float srgb_to_linear(float c) {
+            return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+
+        inline float linear_to_srgb(float c) {
+            return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+        }
+
+        inline const std::array<float, 256> &srgb_to_linear_table() {
+            static const auto table = [] {
+                std::array<float, 256> t{};
+                for (int i = 0; i < 256; ++i) {
+                    t[i] = srgb_to_linear(static_cast<float>(i) / 255.0f);
+                }
+                return t;
+            }();
+            return table;
+        }
+
+        // Reads n cells from x, normalised, optionally decoding sRGB to linear light on the way.
+        template <typename T>
+        void load_block(const channel_row<T> &row, long x, long n, color_block_data &block, bool linearize) {
+            constexpr float scale = std::is_same_v<std::remove_const_t<T>, char> ? 1.0f / 255.0f : 1.0f;
+            for (int k = 0; k < 4; ++k) {
+                float *out = block[k];
+                if (row.c[k] == nullptr) {
+                    std::fill_n(out, n, 1.0f);
+                    continue;
+                }
+                const auto *in = row.c[k] + x * row.stride[k];
+                const long stride = row.stride[k];
+                if constexpr (std::is_same_v<std::remove_const_t<T>, char>) {
+                    if (linearize && k < 3) {
+                        const auto &table = srgb_to_linear_table();
+                        for (long i = 0; i < n; ++i) {
+                            out[i] = table[static_cast<unsigned char>(in[i * stride])];
+                        }
+                        continue;
+                    }
+                }
+                for (long i = 0; i < n; ++i) {
+                    out[i] = cell_to<float>(in[i * stride]) * scale;
+                }
+                if (linearize && k < 3) {
+                    for (long i = 0; i < n; ++i) {
+                        out[i] = srgb_to_linear(out[i]);
+                    }
+                }
+            }
+        }
+
+        template <typename T>
+        void store_block(const channel_row<T> &row, long x, long n, const color_block_data &block) {
+            for (int k = 0; k < 4; ++k) {
+                if (row.c[k] == nullptr) {
+                    continue;
+                }
+                T *out = row.c[k] + x * row.stride[k];
+                const long stride = row.stride[k];
+                const float *in = block[k];
+                for (long i = 0; i < n; ++i) {
+                    if constexpr (std::is_same_v<T, char>) {
+                        out[i * stride] = cell_from<char>(in[i] * 255.0f);
+                    } else {
+                        out[i * stride] = cell_from<T>(in[i]);
+                    }
+                }
+            }
+        }
+
+        // Applies a 3x3 matrix plus offset to channels 0-2 of the block.
+        inline void transform_block(color_block_data &block, long n, const float (&m)[3][3],
+                                    const float (&offset)[3] = {0.0f, 0.0f, 0.0f}) {
+            for (long i = 0; i < n; i += 4) {
+                const f32x4 a = f32x4::load(block[0] + i), b = f32x4::load(block[1] + i), c = f32x4::load(block[2] + i);
+                for (int r = 0; r < 3; ++r) {
+                    const f32x4 v = fma(fma(fma(f32x4::set1(offset[r]), a, f32x4::set1(m[r][0])), b,
+                                            f32x4::set1(m[r][1])), c, f32x4::set1(m[r][2]));
+                    v.store(block[r] + i);
+                }
+            }
+        }
+
+        constexpr float rgb_to_yuv_m[3][3] = {
+            {0.299f, 0.587f, 0.114f},
+            {-0.168736f, -0.331264f, 0.5f},
+            {0.5f, -0.418688f, -0.081312f},
+        };
+        constexpr float yuv_to_rgb_m[3][3] = {
+            {1.0f, 0.0f, 1.402f},
+            {1.0f, -0.344136f, -0.714136f},
+            {1.0f, 1.772f, 0.0f},
+        };
+        // sRGB primaries, D65, with the white point divided out of the forward matrix and into the inverse
+        constexpr float rgb_to_xyz_m[3][3] = {
+            {0.4124564f / 0.95047f, 0.3575761f / 0.95047f, 0.1804375f / 0.95047f},
+            {0.2126729f, 0.7151522f, 0.0721750f},
+            {0.0193339f / 1.08883f, 0.1191920f / 1.08883f, 0.9503041f / 1.08883f},
+        };
+        constexpr float xyz_to_rgb_m[3][3] = {
+            {3.2404542f * 0.95047f, -1.5371385f, -0.4985314f * 1.08883f},
+            {-0.9692660f * 0.95047f, 1.8760108f, 0.0415560f * 1.08883f},
+            {0.0556434f * 0.95047f, -0.2040259f, 1.0572252f * 1.08883f},
+        };
+
+        inline void rgb_to_hsv(color_block_data &block, long n) {
+            const f32x4 zero = f32x4::zero(), one = f32x4::set1(1.0f), sixth = f32x4::set1(1.0f / 6.0f);
+            for (long i = 0; i < n; i += 4) {
+                const f32x4 r = f32x4::load(block[0] + i), g = f32x4::load(block[1] + i), b = f32x4::load(block[2] + i);
+                const f32x4 v = max(max(r, g), b);
+                const f32x4 d = v - min(min(r, g), b);
+                const f32x4 safe = select_gt(d, zero, d, one);
+                f32x4 h = select_eq(v, r, (g - b) / safe,
+                                    select_eq(v, g, (b - r) / safe + f32x4::set1(2.0f),
+                                              (r - g) / safe + f32x4::set1(4.0f))) * sixth;
+                h = select_gt(zero, h, h + one, h);
+                h = select_gt(d, zero, h, zero);
+                const f32x4 s = select_gt(v, zero, d / select_gt(v, zero, v, one), zero);
+                h.store(block[0] + i);
+                s.store(block[1] + i);
+                v.store(block[2] + i);
+            }
+        }
+
+        inline void hsv_to_rgb(color_block_data &block, long n) {
+            // c = v - v * s * clamp(min(k, 4 - k), 0, 1) with k = (offset + 6h) mod 6
+            const f32x4 zero = f32x4::zero(), one = f32x4::set1(1.0f), six = f32x4::set1(6.0f);
+            const f32x4 four = f32x4::set1(4.0f);
+            const float offsets[3] = {5.0f, 3.0f, 1.0f};
+            for (long i = 0; i < n; i += 4) {
+                const f32x4 h = min(max(f32x4::load(block[0] + i), zero), one) * six;
+                const f32x4 s = f32x4::load(block[1] + i), v = f32x4::load(block[2] + i);
+                const f32x4 vs = v * s;
+                for (int c = 0; c < 3; ++c) {
+                    f32x4 k = h + f32x4::set1(offsets[c]);
+                    k = k - truncate(k / six) * six;
+                    const f32x4 w = max(min(min(k, four - k), one), zero);
+                    (v - vs * w).store(block[c] + i);
+                }
+            }
+        }
+
+        inline void linear_to_lab(color_block_data &block, long n) {
+            constexpr float delta = 6.0f / 29.0f;
+            transform_block(block, n, rgb_to_xyz_m);
+            for (int c = 0; c < 3; ++c) {
+                for (long i = 0; i < n; ++i) {
+                    const float t = block[c][i];
+                    block[c][i] = t > delta * delta * delta ? std::cbrt(t) : t / (3.0f * delta * delta) + 4.0f / 29.0f;
+                }
+            }
+            // L / 100 = 1.16 fy - 0.16, (500 (fx - fy) + 128) / 255, (200 (fy - fz) + 128) / 255
+            constexpr float m[3][3] = {
+                {0.0f, 1.16f, 0.0f},
+                {500.0f / 255.0f, -500.0f / 255.0f, 0.0f},
+                {0.0f, 200.0f / 255.0f, -200.0f / 255.0f},
+            };
+            transform_block(block, n, m, {-0.16f, 128.0f / 255.0f, 128.0f / 255.0f});
+        }
+
+        inline void lab_to_linear(color_block_data &block, long n) {
+            constexpr float delta = 6.0f / 29.0f;
+            // back to fx, fy, fz
+            constexpr float m[3][3] = {
+                {1.0f / 1.16f, 255.0f / 500.0f, 0.0f},
+                {1.0f / 1.16f, 0.0f, 0.0f},
+                {1.0f / 1.16f, 0.0f, -255.0f / 200.0f},
+            };
+            transform_block(block, n, m, {
+                                0.16f / 1.16f - 128.0f / 500.0f, 0.16f / 1.16f, 0.16f / 1.16f + 128.0f / 200.0f
+                            });
+            const f32x4 d = f32x4::set1(delta), k = f32x4::set1(3.0f * delta * delta), bias = f32x4::set1(4.0f / 29.0f);
+            for (int c = 0; c < 3; ++c) {
+                for (long i = 0; i < n; i += 4) {
+                    const f32x4 f = f32x4::load(block[c] + i);
+                    select_gt(f, d, f * f * f, k * (f - bias)).store(block[c] + i);
+                }
+            }
+            transform_block(block, n, xyz_to_rgb_m);
+        }
+
+        // Converts channels 0-2 of the block from rgb (linear light if `linear`) to `to`.
+        inline void rgb_to(color_space to, color_block_data &block, long n, bool linear) {
+            switch (to) {
+                case color_space::grey:
+                case color_space::yuv:
+                    transform_block(block, n, rgb_to_yuv_m, {0.0f, 0.5f, 0.5f});
+                    if (to == color_space::grey) {
+                        std::copy_n(block[0], n, block[1]);
+                        std::copy_n(block[0], n, block[2]);
+                    }
+                    break;
+                case color_space::hsv:
+                    rgb_to_hsv(block, n);
+                    break;
+                case color_space::lab:
+                    if (!linear) {
+                        for (int c = 0; c < 3; ++c) {
+                            std::transform(block[c], block[c] + n, block[c], srgb_to_linear);
+                        }
+                    }
+                    linear_to_lab(block, n);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        inline void to_rgb(color_space from, color_block_data &block, long n) {
+            switch (from) {
+                case color_space::yuv:
+                    transform_block(block, n, yuv_to_rgb_m, {
+                                        -1.402f * 0.5f, (0.344136f + 0.714136f) * 0.5f, -1.772f * 0.5f
+                                    });
+                    break;
+                case color_space::hsv:
+                    hsv_to_rgb(block, n);
+                    break;
+                case color_space::lab:
+                    lab_to_linear(block, n);
+                    for (int c = 0; c < 3; ++c) {
+                        for (long i = 0; i < n; ++i) {
+                            block[c][i] = linear_to_srgb(std::clamp(block[c][i], 0.0f, 1.0f));
+                        }
+                    }
+                    break;
+                default:
+                    // grey is already replicated across the three channels
+                    break;
+            }
+        }
+
+        // Channel pointers into one row of an interleaved matrix holding `space`. Grey is read from the first
+        // channel plane into all three channels, and written to every channel plane.
+        template <typename T>
+        channel_row<T> interleaved_row(T *p, long planes, color_space space) {
+            channel_row<T> row;
+            const long first = planes == 4 ? 1 : 0;
+            for (int k = 0; k < 3; ++k) {
+                if constexpr (std::is_const_v<T>) {
+                    row.c[k] = p + first + (space == color_space::grey ? 0 : k);
+                } else {
+                    row.c[k] = planes == 1 && k > 0 ? nullptr : p + first + k;
+                }
+                row.stride[k] = planes;
+            }
+            if (planes == 4) {
+                row.c[3] = p;
+                row.stride[3] = planes;
+            }
+            return row;
+        }
+
+        template <typename S, typename D>
+        void convert_rows(long width, long height, color_space from, color_space to, auto &&src_row,
+                          auto &&dst_row) {
+            parallel_for(0, height, std::max(1l, (1l << 13) / std::max(1l, width)), [&](size_t begin, size_t end) {
+                alignas(16) color_block_data block;
+                for (long y = static_cast<long>(begin); y < static_cast<long>(end); ++y) {
+                    const channel_row<const S> in = src_row(y);
+                    const channel_row<D> out = dst_row(y);
+                    const bool linear = from == color_space::rgb && to == color_space::lab;
+                    for (long x = 0; x < width; x += color_block) {
+                        const long n = std::min(color_block, width - x);
+                        // pad to whole f32x4s; the extra lanes are computed and dropped
+                        const long padded = (n + 3) & ~3l;
+                        load_block(in, x, n, block, linear);
+                        for (int k = 0; k < 4; ++k) {
+                            std::fill(block[k] + n, block[k] + padded, 0.0f);
+                        }
+                        if (from != to) {
+                            to_rgb(from, block, padded);
+                            rgb_to(to, block, padded, linear);
+                        }
+                        store_block(out, x, n, block);
+                    }
+                }
+            });
+        }
+
+        inline bool color_planes_ok(long planecount) {
+            return planecount == 1 || planecount == 3 || planecount == 4;
+        }
+    }
+
+    // Converts between colour spaces, and between char and float32 (normalising char to [0, 1]) in the same
+    // pass. Alpha is copied when both matrices have it and set to opaque when only dst does. src and dst may be
+    // the same matrix.
+    template <typename S, typename D>
+    t_jit_err convert_color(matrix_view<S> src, color_space from, matrix_view<D> dst, color_space to) {
+        const long sp = static_cast<long>(src.planecount()), dp = static_cast<long>(dst.planecount());
+        if (!detail::color_planes_ok(sp) || !detail::color_planes_ok(dp)
+            || (sp == 1 && from != color_space::grey) || (dp == 1 && to != color_space::grey)) {
+            return JIT_ERR_MISMATCH_PLANE;
+        }
+        if (src.dimcount() != dst.dimcount() || src.dimcount() > 2 || src.ncols() != dst.ncols()
+            || (src.dimcount() == 2 && src.nrows() != dst.nrows())) {
+            return JIT_ERR_MISMATCH_DIM;
+        }
+        trace_scope span{"convert_color", "color"};
+        detail::convert_rows<S, D>(src.ncols(), src.dimcount() > 1 ? src.nrows() : 1, from, to,
+                                   [&](long y) {
+                                       return detail::interleaved_row<const S>(src.row(y).as_1d_span().data(), sp, from);
+                                   },
+                                   [&](long y) {
+                                       return detail::interleaved_row<D>(dst.row(y).as_1d_span().data(), dp, to);
+                                   });
+        return JIT_ERR_NONE;
+    }
+
+    // Converts to separate planes, e.g. three 1-plane matrices for Y, U and V. The planes must all have src's
+    // dims; alpha is dropped.
+    template <typename S, typename D>
+    t_jit_err convert_color(matrix_view<S> src, color_space from, std::array<plane_view<D>, 3> dst, color_space to) {
+        const long sp = static_cast<long>(src.planecount());
+        if (!detail::color_planes_ok(sp) || (sp == 1 && from != color_space::grey)) {
+            return JIT_ERR_MISMATCH_PLANE;
+        }
+        for (auto &p: dst) {
+            auto &m = p.matrix();
+            if (m.dimcount() != src.dimcount() || m.ncols() != src.ncols()
+                || (src.dimcount() == 2 && m.nrows() != src.nrows())) {
+                return JIT_ERR_MISMATCH_DIM;
+            }
+        }
+        trace_scope span{"convert_color", "color"};
+        detail::convert_rows<S, D>(src.ncols(), src.dimcount() > 1 ? src.nrows() : 1, from, to,
+                                   [&](long y) {
+                                       return detail::interleaved_row<const S>(src.row(y).as_1d_span().data(), sp, from);
+                                   },
+                                   [&](long y) {
+                                       detail::channel_row<D> row;
+                                       for (int k = 0; k < 3; ++k) {
+                                           auto &m = dst[k].matrix();
+                                           row.c[k] = m.row(y).as_1d_span().data() + dst[k].plane();
+                                           row.stride[k] = static_cast<long>(m.planecount());
+                                       }
+                                       return row;
+                                   });
+        return JIT_ERR_NONE;
+    }
+
+    // Converts from separate planes, the inverse of the above. dst gets opaque alpha if it has a plane for it.
+    template <typename S, typename D>
+    t_jit_err convert_color(std::array<plane_view<S>, 3> src, color_space from, matrix_view<D> dst, color_space to) {
+        const long dp = static_cast<long>(dst.planecount());
+        if (!detail::color_planes_ok(dp) || (dp == 1 && to != color_space::grey)) {
+            return JIT_ERR_MISMATCH_PLANE;
+        }
+        for (auto &p: src) {
+            auto &m = p.matrix();
+            if (m.dimcount() != dst.dimcount() || m.ncols() != dst.ncols()
+                || (dst.dimcount() == 2 && m.nrows() != dst.nrows())) {
+                return JIT_ERR_MISMATCH_DIM;
+            }
+        }
+        trace_scope span{"convert_color", "color"};
+        detail::convert_rows<S, D>(dst.ncols(), dst.dimcount() > 1 ? dst.nrows() : 1, from, to,
+                                   [&](long y) {
+                                       detail::channel_row<const S> row;
+                                       for (int k = 0; k < 3; ++k) {
+                                           auto &m = src[k].matrix();
+                                           row.c[k] = m.row(y).as_1d_span().data() + src[k].plane();
+                                           row.stride[k] = static_cast<long>(m.planecount());
+                                       }
+                                       return row;
+                                   },
+                                   [&](long y) {
+                                       return detail::interleaved_row<D>(dst.row(y).as_1d_span().data(), dp, to);
+                                   });
+        return JIT_ERR_NONE;
+    }
+}
+
+#endif //COLORSPACE_HPP
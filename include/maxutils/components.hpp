@@ -0,0 +1,280 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef COMPONENTS_HPP
+#define COMPONENTS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "c74_jitter.h"
+#include "jit_matrix_view_v2.hpp"
+#include "tracer.hpp"
+#include "detail/parallel.hpp"
+
+namespace maxutils {
+    using namespace c74::max;
+
+    enum class connectivity {
+        four,
+        eight,
+    };
+
+    // Area in cells, inclusive bounding box and centroid (cell centres at integer coordinates) of one blob.
+    struct blob_stats {
+        long area;
+        long min_x;
+        long min_y;
+        long max_x;
+        long max_y;
+        double centroid_x;
+        double centroid_y;
+    };
+
+    namespace detail {
+        struct blob_partial {
+            long area = 0;
+            long min_x = std::numeric_limits<long>::max();
+            long min_y = std::numeric_limits<long>::max();
+            long max_x = -1;
+            long max_y = -1;
+            int64_t sum_x = 0;
+            int64_t sum_y = 0;
+
+            void add(long x, long y) {
+                ++area;
+                min_x = std::min(min_x, x);
+                min_y = std::min(min_y, y);
+                max_x = std::max(max_x, x);
+                max_y = std::max(max_y, y);
+                sum_x += x;
+                sum_y += y;
+            }
+
+            void merge(const blob_partial &other) {
+                area += other.area;
+                min_x = std::min(min_x, other.min_x);
+                min_y = std::min(min_y, other.min_y);
+                max_x = std::max(max_x, other.max_x);
+                max_y = std::max(max_y, other.max_y);
+                sum_x += other.sum_x;
+                sum_y += other.sum_y;
+            }
+        };
+
+        // Union-find over provisional labels. Roots are always the smallest label in their set, so every
+        // parent is below its child.
+        inline int32_t find_root(std::vector<int32_t> &parent, int32_t l) {
+            while (parent[l] != l) {
+                parent[l] = parent[parent[l]];
+                l = parent[l];
+            }
+            return l;
+        }
+
+        inline void unite(std::vector<int32_t> &parent, int32_t a, int32_t b) {
+            a = find_root(parent, a);
+            b = find_root(parent, b);
+            if (a < b) {
+                parent[b] = a;
+            } else if (b < a) {
+                parent[a] = b;
+            }
+        }
+    }
+
+    // Labels the connected foreground regions of a single-plane char mask (cells above threshold) into a
+    // single-plane long matrix of the same dims: 0 for background, 1..count() for blobs numbered in raster order
+    // of their first cell, so the result doesn't depend on the number of threads.
+    //
+    // The mask is cut into horizontal strips that are labelled in parallel, each with its own range of
+    // provisional labels and per-label stats; the rows either side of each cut are then merged, provisional
+    // labels resolved to final ones, and a second parallel pass writes them out. Scratch space is kept between
+    // calls, so reuse one labeller per object.
+    class component_labeller {
+    public:
+        void set_connectivity(connectivity c) {
+            conn = c;
+        }
+
+        void set_threshold(unsigned char t) {
+            threshold = t;
+        }
+
+        // Stats for the first stats.size() blobs go to stats; the rest are still labelled and counted.
+        t_jit_err operator()(matrix_view<char> &mask, matrix_view<int32_t> &labels, std::span<blob_stats> stats = {}) {
+            if (mask.planecount() != 1 || labels.planecount() != 1) {
+                return JIT_ERR_MISMATCH_PLANE;
+            }
+            if (mask.dimcount() > 2 || labels.dimcount() != mask.dimcount() || labels.ncols() != mask.ncols()
+                || (mask.dimcount() == 2 && labels.nrows() != mask.nrows())) {
+                return JIT_ERR_MISMATCH_DIM;
+            }
+            const long w = mask.ncols(), h = mask.dimcount() == 2 ? mask.nrows() : 1;
+            if (w * h >= std::numeric_limits<int32_t>::max()) {
+                return JIT_ERR_OUT_OF_BOUNDS;
+            }
+            trace_scope span{"label_components", "matrix"};
+
+            const long strip_rows = std::max(16l, h / static_cast<long>(detail::thread_pool::get().concurrency() * 4));
+            const long strip_count = (h + strip_rows - 1) / strip_rows;
+            strips.resize(strip_count);
+            if (parent.size() < static_cast<size_t>(w * h + 1)) {
+                parent.resize(w * h + 1);
+            }
+
+            detail::parallel_for(0, strip_count, 1, [&](size_t begin, size_t end) {
+                for (size_t k = begin; k < end; ++k) {
+                    label_strip(mask, labels, k * strip_rows, std::min(h, static_cast<long>(k + 1) * strip_rows), k);
+                }
+            });
+            for (long k = 1; k < strip_count; ++k) {
+                merge_rows(mask, labels, k * strip_rows);
+            }
+            resolve(stats);
+            detail::parallel_for(0, h, std::max(1l, 4096 / w), [&](size_t begin, size_t end) {
+                for (size_t y = begin; y < end; ++y) {
+                    for (auto &l: labels.row(y).as_1d_span()) {
+                        l = l ? parent[l] : 0;
+                    }
+                }
+            });
+            return JIT_ERR_NONE;
+        }
+
+        [[nodiscard]] size_t count() const {
+            return blobs;
+        }
+
+    private:
+        struct strip {
+            int32_t base;
+            std::vector<detail::blob_partial> partials;
+        };
+
+        bool foreground(char c) const {
+            return static_cast<unsigned char>(c) > threshold;
+        }
+
+        // Raster-order first pass over rows [y0, y1) using labels from y0 * w + 1 up, looking only at cells
+        // within the strip.
+        void label_strip(matrix_view<char> &mask, matrix_view<int32_t> &labels, long y0, long y1, size_t k) {
+            const long w = mask.ncols();
+            auto &s = strips[k];
+            s.base = static_cast<int32_t>(y0 * w + 1);
+            s.partials.clear();
+            int32_t next = s.base;
+            const bool diagonal = conn == connectivity::eight;
+            for (long y = y0; y < y1; ++y) {
+                const char *m = mask.row(y).as_1d_span().data();
+                int32_t *out = labels.row(y).as_1d_span().data();
+                const int32_t *up = y > y0 ? labels.row(y - 1).as_1d_span().data() : nullptr;
+                for (long x = 0; x < w; ++x) {
+                    if (!foreground(m[x])) {
+                        out[x] = 0;
+                        continue;
+                    }
+                    int32_t l = x > 0 ? out[x - 1] : 0;
+                    const auto join = [&](int32_t n) {
+                        if (!n) {
+                            return;
+                        }
+                        if (!l) {
+                            l = n;
+                        } else if (n != l) {
+                            detail::unite(parent, l, n);
+                        }
+                    };
+                    if (up) {
+                        join(up[x]);
+                        if (diagonal) {
+                            join(x > 0 ? up[x - 1] : 0);
+                            join(x + 1 < w ? up[x + 1] : 0);
+                        }
+                    }
+                    if (!l) {
+                        l = next++;
+                        parent[l] = l;
+                        s.partials.emplace_back();
+                    }
+                    out[x] = l;
+                    s.partials[l - s.base].add(x, y);
+                }
+            }
+        }
+
+        // Joins blobs across the cut between row y - 1 and row y.
+        void merge_rows(matrix_view<char> &mask, matrix_view<int32_t> &labels, long y) {
+            const long w = mask.ncols();
+            const int32_t *row = labels.row(y).as_1d_span().data();
+            const int32_t *up = labels.row(y - 1).as_1d_span().data();
+            const bool diagonal = conn == connectivity::eight;
+            for (long x = 0; x < w; ++x) {
+                if (!row[x]) {
+                    continue;
+                }
+                if (up[x]) {
+                    detail::unite(parent, row[x], up[x]);
+                }
+                if (diagonal) {
+                    if (x > 0 && up[x - 1]) {
+                        detail::unite(parent, row[x], up[x - 1]);
+                    }
+                    if (x + 1 < w && up[x + 1]) {
+                        detail::unite(parent, row[x], up[x + 1]);
+                    }
+                }
+            }
+        }
+
+        // Visits provisional labels in increasing order, so each one's parent has already been replaced by its
+        // final label, and sums the strips' partial stats per blob.
+        void resolve(std::span<blob_stats> stats) {
+            blobs = 0;
+            totals.assign(stats.size(), {});
+            for (const auto &s: strips) {
+                for (size_t i = 0; i < s.partials.size(); ++i) {
+                    const int32_t l = s.base + static_cast<int32_t>(i);
+                    parent[l] = parent[l] == l ? static_cast<int32_t>(++blobs) : parent[parent[l]];
+                    if (static_cast<size_t>(parent[l]) <= totals.size()) {
+                        totals[parent[l] - 1].merge(s.partials[i]);
+                    }
+                }
+            }
+            for (size_t i = 0; i < std::min(blobs, stats.size()); ++i) {
+                const auto &t = totals[i];
+                stats[i] = {
+                    t.area, t.min_x, t.min_y, t.max_x, t.max_y,
+                    static_cast<double>(t.sum_x) / t.area, static_cast<double>(t.sum_y) / t.area
+                };
+            }
+        }
+
+        connectivity conn = connectivity::eight;
+        unsigned char threshold = 0;
+        size_t blobs = 0;
+        std::vector<int32_t> parent;
+        std::vector<strip> strips;
+        std::vector<detail::blob_partial> totals;
+    };
+
+    // One-shot form; returns the number of blobs in count. It labels with a static thread_local labeller, whose
+    // scratch space (a word per cell of the largest mask seen) stays allocated for the lifetime of the calling
+    // thread. Objects that label every frame should own a component_labeller instead.
+    inline t_jit_err label_components(matrix_view<char> &mask, matrix_view<int32_t> &labels,
+                                      std::span<blob_stats> stats, size_t &count,
+                                      connectivity conn = connectivity::eight, unsigned char threshold = 0) {
+        static thread_local component_labeller instance;
+        instance.set_connectivity(conn);
+        instance.set_threshold(threshold);
+        auto err = instance(mask, labels, stats);
+        count = err ? 0 : instance.count();
+        return err;
+    }
+}
+
+#endif //COMPONENTS_HPP
@@ -0,0 +1,537 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef CONVOLVE_HPP
+#define CONVOLVE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "c74_jitter.h"
+#include "jit_matrix_view_v2.hpp"
+#include "tracer.hpp"
+#include "detail/cell_convert.hpp"
+#include "detail/content_hash.hpp"
+#include "detail/fft.hpp"
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+
+namespace maxutils {
+    using namespace c74::max;
+
+    // What cells outside the matrix read as, in the same order as Jitter's boundmode attribute.
+    enum class boundmode {
+        ignore, // cells the kernel doesn't fully cover keep their input value
+        clear,  // zero
+        wrap,   // tile
+        clip,   // repeat the edge cells
+        fold,   // mirror about the edge cells
+    };
+
+    enum class convolve_method {
+        automatic, // separable if the kernel is, otherwise direct up to 15x15 and FFT beyond
+        direct,
+        separable,
+        fft,
+    };
+
+    // A 2D kernel stored row-major, applied centred on each cell (at width / 2, height / 2) as a correlation,
+    // i.e. without flipping. Rank-1 kernels are detected on construction and can run as two 1D passes.
+    class convolution_kernel {
+    public:
+        convolution_kernel() : convolution_kernel(1, 1, {1.0f}) {
+        }
+
+        convolution_kernel(long width, long height, std::vector<float> taps)
+            : w{width}, h{height}, values{std::move(taps)} {
+            if (w < 1 || h < 1 || values.size() != static_cast<size_t>(w * h)) {
+                throw std::runtime_error("Kernel size mismatch");
+            }
+            analyse();
+        }
+
+        static convolution_kernel gaussian(float sigma, long size = 0) {
+            if (size < 1) {
+                size = 2 * static_cast<long>(std::ceil(3.0f * sigma)) + 1;
+            }
+            std::vector<float> line(size);
+            float sum = 0.0f;
+            for (long i = 0; i < size; ++i) {
+                const float x = static_cast<float>(i - size / 2);
+                line[i] = sigma > 0.0f ? std::exp(-x * x / (2.0f * sigma * sigma)) : (x == 0.0f ? 1.0f : 0.0f);
+                sum += line[i];
+            }
+            for (auto &v: line) {
+                v /= sum;
+            }
+            return outer(line, line);
+        }
+
+        // column * row^T
+        static convolution_kernel outer(const std::vector<float> &column, const std::vector<float> &row) {
+            std::vector<float> taps(column.size() * row.size());
+            for (size_t y = 0; y < column.size(); ++y) {
+                for (size_t x = 0; x < row.size(); ++x) {
+                    taps[y * row.size() + x] = column[y] * row[x];
+                }
+            }
+            return {static_cast<long>(row.size()), static_cast<long>(column.size()), std::move(taps)};
+        }
+
+        // Reads plane 0 of a float32 matrix, e.g. one sent to a kernel inlet.
+        static convolution_kernel from_matrix(matrix_view<float> &m) {
+            const long width = m.ncols();
+            const long height = m.dimcount() > 1 ? m.nrows() : 1;
+            std::vector<float> taps(width * height);
+            for (long y = 0; y < height; ++y) {
+                auto row = m.row(y);
+                for (long x = 0; x < width; ++x) {
+                    taps[y * width + x] = row[x][0];
+                }
+            }
+            return {width, height, std::move(taps)};
+        }
+
+        [[nodiscard]] long width() const { return w; }
+        [[nodiscard]] long height() const { return h; }
+        [[nodiscard]] const std::vector<float> &taps() const { return values; }
+        [[nodiscard]] float at(long x, long y) const { return values[y * w + x]; }
+
+        [[nodiscard]] bool separable() const { return !row_factor.empty(); }
+        [[nodiscard]] const std::vector<float> &row() const { return row_factor; }
+        [[nodiscard]] const std::vector<float> &column() const { return column_factor; }
+
+        [[nodiscard]] uint64_t hash() const { return hash_; }
+
+    private:
+        void analyse() {
+            hash_ = detail::content_hash{static_cast<uint64_t>(w) << 32 | static_cast<uint64_t>(h)}
+                    .update(values.data(), values.size() * sizeof(float)).digest();
+
+            // rank 1 if every row is a multiple of the row holding the largest tap
+            const auto largest = std::max_element(values.begin(), values.end(),
+                                                  [](float a, float b) { return std::abs(a) < std::abs(b); });
+            const float peak = *largest;
+            if (peak == 0.0f) {
+                return;
+            }
+            const long py = (largest - values.begin()) / w;
+            const long px = (largest - values.begin()) % w;
+            std::vector<float> col(h), row(w);
+            for (long y = 0; y < h; ++y) {
+                col[y] = at(px, y);
+            }
+            for (long x = 0; x < w; ++x) {
+                row[x] = at(x, py) / peak;
+            }
+            const float tolerance = std::abs(peak) * 1e-5f;
+            for (long y = 0; y < h; ++y) {
+                for (long x = 0; x < w; ++x) {
+                    if (std::abs(col[y] * row[x] - at(x, y)) > tolerance) {
+                        return;
+                    }
+                }
+            }
+            row_factor = std::move(row);
+            column_factor = std::move(col);
+        }
+
+        long w;
+        long h;
+        std::vector<float> values;
+        std::vector<float> row_factor;
+        std::vector<float> column_factor;
+        uint64_t hash_ = 0;
+    };
+
+    namespace detail {
+        // Maps i onto [0, n) for the bound mode, or -1 for a cleared cell. ignore is treated as clip here.
+        inline long bound_index(long i, long n, boundmode mode) {
+            if (i >= 0 && i < n) {
+                return i;
+            }
+            switch (mode) {
+                case boundmode::clear:
+                    return -1;
+                case boundmode::wrap:
+                    i %= n;
+                    return i < 0 ? i + n : i;
+                case boundmode::fold: {
+                    if (n == 1) {
+                        return 0;
+                    }
+                    const long period = 2 * (n - 1);
+                    i %= period;
+                    if (i < 0) {
+                        i += period;
+                    }
+                    return i < n ? i : period - i;
+                }
+                default:
+                    return std::clamp(i, 0l, n - 1);
+            }
+        }
+
+        // out[i] += weight * in[i] for i < n
+        inline void accumulate(float *out, const float *in, float weight, long n) {
+            const auto w = f32x4::set1(weight);
+            long i = 0;
+            for (; i + 4 <= n; i += 4) {
+                fma(f32x4::load(out + i), w, f32x4::load(in + i)).store(out + i);
+            }
+            for (; i < n; ++i) {
+                out[i] += weight * in[i];
+            }
+        }
+
+        inline std::vector<float> &convolve_scratch(size_t slot) {
+            static thread_local std::vector<float> scratch[2];
+            return scratch[slot];
+        }
+    }
+
+    // Convolves matrix_views with a convolution_kernel, choosing between direct, separable and FFT
+    // implementations. Work is spread over rows (and FFT columns) on the maxutils thread pool. The spectrum
+    // of the kernel is kept between frames, so it is only recomputed when the kernel or frame size changes.
+    // src and dst must be different matrices with the same type, planecount and dims (1D or 2D).
+    class convolver {
+    public:
+        static constexpr long direct_limit = 15 * 15;
+
+        void set_kernel(convolution_kernel k) {
+            kernel = std::move(k);
+        }
+
+        [[nodiscard]] const convolution_kernel &get_kernel() const {
+            return kernel;
+        }
+
+        void set_bounds(boundmode mode) {
+            bounds = mode;
+        }
+
+        void set_method(convolve_method m) {
+            method = m;
+        }
+
+        [[nodiscard]] convolve_method resolved_method() const {
+            if (method == convolve_method::separable && !kernel.separable()) {
+                return convolve_method::direct;
+            }
+            if (method != convolve_method::automatic) {
+                return method;
+            }
+            if (kernel.separable()) {
+                return convolve_method::separable;
+            }
+            return kernel.width() * kernel.height() <= direct_limit ? convolve_method::direct : convolve_method::fft;
+        }
+
+        template <typename T>
+        t_jit_err operator()(matrix_view<T> &src, matrix_view<T> &dst) {
+            if (src.overlaps(dst)) {
+                return JIT_ERR_INVALID_OUTPUT;
+            }
+            if (src.planecount() != dst.planecount()) {
+                return JIT_ERR_MISMATCH_PLANE;
+            }
+            if (src.dimcount() != dst.dimcount() || src.dimcount() > 2 || src.ncols() != dst.ncols()
+                || (src.dimcount() == 2 && src.nrows() != dst.nrows())) {
+                return JIT_ERR_MISMATCH_DIM;
+            }
+            const frame f{src.ncols(), src.dimcount() > 1 ? src.nrows() : 1, static_cast<long>(src.planecount())};
+            if (f.width < 1 || f.height < 1) {
+                return JIT_ERR_NONE;
+            }
+            switch (resolved_method()) {
+                case convolve_method::separable: {
+                    trace_scope span{"convolve separable", "convolve"};
+                    run_separable(src, dst, f);
+                    break;
+                }
+                case convolve_method::fft: {
+                    trace_scope span{"convolve fft", "convolve"};
+                    run_fft(src, dst, f);
+                    break;
+                }
+                default: {
+                    trace_scope span{"convolve direct", "convolve"};
+                    run_direct(src, dst, f);
+                    break;
+                }
+            }
+            if (bounds == boundmode::ignore) {
+                restore_edges(src, dst, f);
+            }
+            return JIT_ERR_NONE;
+        }
+
+    private:
+        struct frame {
+            long width;
+            long height;
+            long planes;
+        };
+
+        [[nodiscard]] size_t row_grain(const frame &f) const {
+            return std::max(1l, (1l << 14) / std::max(1l, f.width * f.planes * kernel.width()));
+        }
+
+        // Converts source row y (already mapped by bound_index, -1 for cleared) to float, extended by
+        // left / right cells on each side according to the bound mode.
+        template <typename T>
+        void load_row(matrix_view<T> &src, const frame &f, long y, long left, long right, float *out) const {
+            const long total = (f.width + left + right) * f.planes;
+            if (y < 0) {
+                std::fill_n(out, total, 0.0f);
+                return;
+            }
+            const T *in = src.row(y).as_1d_span().data();
+            for (long i = 0; i < f.width * f.planes; ++i) {
+                out[left * f.planes + i] = detail::cell_to<float>(in[i]);
+            }
+            auto extend = [&](long x) {
+                const long sx = detail::bound_index(x, f.width, bounds);
+                for (long p = 0; p < f.planes; ++p) {
+                    out[(x + left) * f.planes + p] = sx < 0 ? 0.0f : detail::cell_to<float>(in[sx * f.planes + p]);
+                }
+            };
+            for (long x = -left; x < 0; ++x) {
+                extend(x);
+            }
+            for (long x = f.width; x < f.width + right; ++x) {
+                extend(x);
+            }
+        }
+
+        template <typename T>
+        void store_row(matrix_view<T> &dst, long y, const float *in, long n) const {
+            T *out = dst.row(y).as_1d_span().data();
+            for (long i = 0; i < n; ++i) {
+                out[i] = detail::cell_from<T>(in[i]);
+            }
+        }
+
+        template <typename T>
+        void run_direct(matrix_view<T> &src, matrix_view<T> &dst, const frame &f) {
+            const long kw = kernel.width(), kh = kernel.height();
+            const long ax = kw / 2, ay = kh / 2;
+            const long n = f.width * f.planes;
+            detail::parallel_for(0, f.height, row_grain(f), [&](size_t begin, size_t end) {
+                auto &padded = detail::convolve_scratch(0);
+                auto &acc = detail::convolve_scratch(1);
+                padded.resize((f.width + kw - 1) * f.planes);
+                acc.resize(n);
+                for (long y = static_cast<long>(begin); y < static_cast<long>(end); ++y) {
+                    std::fill(acc.begin(), acc.end(), 0.0f);
+                    for (long ky = 0; ky < kh; ++ky) {
+                        const long sy = detail::bound_index(y + ky - ay, f.height, bounds);
+                        if (sy < 0) {
+                            continue;
+                        }
+                        load_row(src, f, sy, ax, kw - 1 - ax, padded.data());
+                        for (long kx = 0; kx < kw; ++kx) {
+                            if (const float w = kernel.at(kx, ky); w != 0.0f) {
+                                detail::accumulate(acc.data(), padded.data() + kx * f.planes, w, n);
+                            }
+                        }
+                    }
+                    store_row(dst, y, acc.data(), n);
+                }
+            });
+        }
+
+        template <typename T>
+        void run_separable(matrix_view<T> &src, matrix_view<T> &dst, const frame &f) {
+            const auto &row = kernel.row();
+            const auto &column = kernel.column();
+            const long kw = kernel.width(), kh = kernel.height();
+            const long ax = kw / 2, ay = kh / 2;
+            const long n = f.width * f.planes;
+            horizontal.resize(n * f.height);
+
+            detail::parallel_for(0, f.height, row_grain(f), [&](size_t begin, size_t end) {
+                auto &padded = detail::convolve_scratch(0);
+                padded.resize((f.width + kw - 1) * f.planes);
+                for (long y = static_cast<long>(begin); y < static_cast<long>(end); ++y) {
+                    float *out = horizontal.data() + y * n;
+                    std::fill_n(out, n, 0.0f);
+                    load_row(src, f, y, ax, kw - 1 - ax, padded.data());
+                    for (long kx = 0; kx < kw; ++kx) {
+                        if (row[kx] != 0.0f) {
+                            detail::accumulate(out, padded.data() + kx * f.planes, row[kx], n);
+                        }
+                    }
+                }
+            });
+            detail::parallel_for(0, f.height, row_grain(f), [&](size_t begin, size_t end) {
+                auto &acc = detail::convolve_scratch(1);
+                acc.resize(n);
+                for (long y = static_cast<long>(begin); y < static_cast<long>(end); ++y) {
+                    std::fill(acc.begin(), acc.end(), 0.0f);
+                    for (long ky = 0; ky < kh; ++ky) {
+                        const long sy = detail::bound_index(y + ky - ay, f.height, bounds);
+                        if (sy >= 0 && column[ky] != 0.0f) {
+                            detail::accumulate(acc.data(), horizontal.data() + sy * n, column[ky], n);
+                        }
+                    }
+                    store_row(dst, y, acc.data(), n);
+                }
+            });
+        }
+
+        template <typename T>
+        void run_fft(matrix_view<T> &src, matrix_view<T> &dst, const frame &f) {
+            const long kw = kernel.width(), kh = kernel.height();
+            const long ax = kw / 2, ay = kh / 2;
+            const long padded_w = f.width + kw - 1, padded_h = f.height + kh - 1;
+            const size_t pw = detail::next_pow2(padded_w), ph = detail::next_pow2(padded_h);
+            if (row_plan.size() != pw) {
+                row_plan = detail::fft_plan{pw};
+            }
+            if (column_plan.size() != ph) {
+                column_plan = detail::fft_plan{ph};
+            }
+            update_spectrum(pw, ph);
+
+            const float scale = 1.0f / static_cast<float>(pw * ph);
+            image.resize(pw * ph);
+            for (long p = 0; p < f.planes; ++p) {
+                std::fill(image.begin(), image.end(), std::complex<float>{});
+                // the bound-mode extended input, so the circular correlation never wraps into the output
+                detail::parallel_for(0, padded_h, row_grain(f), [&](size_t begin, size_t end) {
+                    for (long y = static_cast<long>(begin); y < static_cast<long>(end); ++y) {
+                        const long sy = detail::bound_index(y - ay, f.height, bounds);
+                        if (sy < 0) {
+                            continue;
+                        }
+                        const T *in = src.row(sy).as_1d_span().data();
+                        for (long x = 0; x < padded_w; ++x) {
+                            const long sx = detail::bound_index(x - ax, f.width, bounds);
+                            if (sx >= 0) {
+                                image[y * pw + x] = detail::cell_to<float>(in[sx * f.planes + p]);
+                            }
+                        }
+                    }
+                });
+                fft_2d(image, pw, ph, padded_h, false);
+                detail::parallel_for(0, image.size(), 1 << 14, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i) {
+                        const auto a = image[i], b = spectrum[i];
+                        image[i] = {a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real()};
+                    }
+                });
+                fft_2d(image, pw, ph, f.height, true);
+                detail::parallel_for(0, f.height, row_grain(f), [&](size_t begin, size_t end) {
+                    for (long y = static_cast<long>(begin); y < static_cast<long>(end); ++y) {
+                        T *out = dst.row(y).as_1d_span().data();
+                        for (long x = 0; x < f.width; ++x) {
+                            out[x * f.planes + p] = detail::cell_from<T>(image[y * pw + x].real() * scale);
+                        }
+                    }
+                });
+            }
+        }
+
+        // Conjugated spectrum of the kernel padded to pw x ph, so that multiplying by it correlates.
+        void update_spectrum(size_t pw, size_t ph) {
+            if (spectrum_key == std::tuple{kernel.hash(), pw, ph}) {
+                return;
+            }
+            trace_scope span{"kernel spectrum", "convolve"};
+            spectrum.assign(pw * ph, {});
+            for (long y = 0; y < kernel.height(); ++y) {
+                for (long x = 0; x < kernel.width(); ++x) {
+                    spectrum[y * pw + x] = kernel.at(x, y);
+                }
+            }
+            fft_2d(spectrum, pw, ph, kernel.height(), false);
+            for (auto &c: spectrum) {
+                c = std::conj(c);
+            }
+            spectrum_key = {kernel.hash(), pw, ph};
+        }
+
+        // Forward: only the first `rows` rows hold data, the rest are zero and skip their row transforms.
+        // Inverse: only the first `rows` rows are needed afterwards.
+        void fft_2d(std::vector<std::complex<float>> &data, size_t pw, size_t ph, size_t rows, bool inverse) const {
+            auto row_pass = [&] {
+                detail::parallel_for(0, rows, 1, [&](size_t begin, size_t end) {
+                    for (size_t y = begin; y < end; ++y) {
+                        inverse ? row_plan.inverse(data.data() + y * pw) : row_plan.forward(data.data() + y * pw);
+                    }
+                });
+            };
+            if (!inverse) {
+                row_pass();
+            }
+            detail::parallel_for(0, pw, 1, [&](size_t begin, size_t end) {
+                static thread_local std::vector<std::complex<float>> column;
+                column.resize(ph);
+                for (size_t x = begin; x < end; ++x) {
+                    for (size_t y = 0; y < ph; ++y) {
+                        column[y] = data[y * pw + x];
+                    }
+                    inverse ? column_plan.inverse(column.data()) : column_plan.forward(column.data());
+                    for (size_t y = 0; y < ph; ++y) {
+                        data[y * pw + x] = column[y];
+                    }
+                }
+            });
+            if (inverse) {
+                row_pass();
+            }
+        }
+
+        template <typename T>
+        void restore_edges(matrix_view<T> &src, matrix_view<T> &dst, const frame &f) const {
+            const long ax = kernel.width() / 2, ay = kernel.height() / 2;
+            const long right = kernel.width() - 1 - ax, bottom = kernel.height() - 1 - ay;
+            for (long y = 0; y < f.height; ++y) {
+                const T *in = src.row(y).as_1d_span().data();
+                T *out = dst.row(y).as_1d_span().data();
+                if (y < ay || y >= f.height - bottom) {
+                    std::copy_n(in, f.width * f.planes, out);
+                    continue;
+                }
+                for (long x = 0; x < f.width; ++x) {
+                    if (x < ax || x >= f.width - right) {
+                        std::copy_n(in + x * f.planes, f.planes, out + x * f.planes);
+                    }
+                }
+            }
+        }
+
+        convolution_kernel kernel;
+        boundmode bounds = boundmode::clip;
+        convolve_method method = convolve_method::automatic;
+        std::vector<float> horizontal;
+        detail::fft_plan row_plan;
+        detail::fft_plan column_plan;
+        std::vector<std::complex<float>> image;
+        std::vector<std::complex<float>> spectrum;
+        std::tuple<uint64_t, size_t, size_t> spectrum_key{};
+    };
+
+    // One-off convolution through a per-thread convolver, which still keeps the kernel spectrum between calls.
+    template <typename T>
+    t_jit_err convolve(matrix_view<T> src, matrix_view<T> dst, const convolution_kernel &kernel,
+                       boundmode bounds = boundmode::clip, convolve_method method = convolve_method::automatic) {
+        static thread_local convolver instance;
+        if (instance.get_kernel().hash() != kernel.hash()) {
+            instance.set_kernel(kernel);
+        }
+        instance.set_bounds(bounds);
+        instance.set_method(method);
+        return instance(src, dst);
+    }
+}
+
+#endif //CONVOLVE_HPP
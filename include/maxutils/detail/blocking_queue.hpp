@@ -0,0 +1,97 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef BLOCKING_QUEUE_HPP
+#define BLOCKING_QUEUE_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace maxutils::detail {
+    // Bounded queue for handing work between threads. Storage is allocated once; push/pop block until
+    // there is room/an element, or until the queue is closed.
+    template <typename T>
+    class blocking_queue {
+    public:
+        explicit blocking_queue(size_t capacity) : slots(capacity) {
+        }
+
+        bool push(T value) {
+            std::unique_lock lock{mutex};
+            not_full.wait(lock, [this] { return closed || count < slots.size(); });
+            if (closed) {
+                return false;
+            }
+            put(std::move(value));
+            not_empty.notify_one();
+            return true;
+        }
+
+        bool try_push(T value) {
+            std::lock_guard lock{mutex};
+            if (closed || count == slots.size()) {
+                return false;
+            }
+            put(std::move(value));
+            not_empty.notify_one();
+            return true;
+        }
+
+        std::optional<T> pop() {
+            std::unique_lock lock{mutex};
+            not_empty.wait(lock, [this] { return closed || count > 0; });
+            if (count == 0) {
+                return std::nullopt;
+            }
+            T value = take();
+            not_full.notify_one();
+            return value;
+        }
+
+        std::optional<T> try_pop() {
+            std::lock_guard lock{mutex};
+            if (count == 0) {
+                return std::nullopt;
+            }
+            T value = take();
+            not_full.notify_one();
+            return value;
+        }
+
+        void close() {
+            {
+                std::lock_guard lock{mutex};
+                closed = true;
+            }
+            not_full.notify_all();
+            not_empty.notify_all();
+        }
+
+    private:
+        void put(T value) {
+            slots[(head + count) % slots.size()] = std::move(value);
+            ++count;
+        }
+
+        T take() {
+            T value = std::move(slots[head]);
+            head = (head + 1) % slots.size();
+            --count;
+            return value;
+        }
+
+        std::mutex mutex;
+        std::condition_variable not_full;
+        std::condition_variable not_empty;
+        std::vector<T> slots;
+        size_t head = 0;
+        size_t count = 0;
+        bool closed = false;
+    };
+}
+
+#endif //BLOCKING_QUEUE_HPP
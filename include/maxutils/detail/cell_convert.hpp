@@ -0,0 +1,44 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef CELL_CONVERT_HPP
+#define CELL_CONVERT_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace maxutils::detail {
+    // Widens a matrix cell to the type used for arithmetic on it. Jitter char data is unsigned.
+    template <typename Acc, typename T>
+    Acc cell_to(T value) {
+        if constexpr (std::is_same_v<T, char>) {
+            return static_cast<Acc>(static_cast<unsigned char>(value));
+        } else {
+            return static_cast<Acc>(value);
+        }
+    }
+
+    // Narrows back to a cell, rounding and saturating for char and long. NaN becomes 0 in a long cell.
+    template <typename T, typename Acc>
+    T cell_from(Acc value) {
+        if constexpr (std::is_same_v<T, char>) {
+            return static_cast<char>(static_cast<unsigned char>(std::clamp(value, Acc{0}, Acc{255}) + Acc{0.5}));
+        } else if constexpr (std::is_same_v<T, int32_t>) {
+            const auto v = static_cast<double>(value);
+            if (std::isnan(v)) {
+                return 0;
+            }
+            constexpr auto lo = static_cast<double>(std::numeric_limits<int32_t>::min());
+            constexpr auto hi = static_cast<double>(std::numeric_limits<int32_t>::max());
+            return static_cast<int32_t>(std::lround(std::clamp(v, lo, hi)));
+        } else {
+            return static_cast<T>(value);
+        }
+    }
+}
+
+#endif //CELL_CONVERT_HPP
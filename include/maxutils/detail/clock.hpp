@@ -0,0 +1,20 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef CLOCK_HPP
+#define CLOCK_HPP
+
+#include <chrono>
+#include <cstdint>
+
+namespace maxutils::detail {
+    inline uint64_t now_ns() {
+        // steady_clock is clock_gettime(CLOCK_MONOTONIC) / mach_absolute_time underneath, which avoids
+        // having to calibrate rdtsc and works the same on both halves of a universal binary.
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+#endif //CLOCK_HPP
@@ -0,0 +1,189 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef CONTENT_HASH_HPP
+#define CONTENT_HASH_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "simd.hpp"
+
+namespace maxutils::detail {
+    // 64-bit non-cryptographic hash in the style of XXH3: 8 lanes of 64-bit accumulators eat 64-byte stripes
+    // with a 32x32->64 multiply against a keyed copy of the data, so the inner loop maps onto SSE2 / NEON.
+    // Not bit-compatible with XXH3, and only meant for change detection within a process.
+    class content_hash {
+    public:
+        static constexpr size_t stripe_size = 64;
+        static constexpr size_t stripes_per_block = 16;
+
+        explicit content_hash(uint64_t seed = 0) : length{0}, buffered{0} {
+            acc = {prime32_3, prime64_1, prime64_2, prime64_3, prime64_4, prime32_2, prime64_5, prime32_1};
+            for (auto &a: acc) {
+                a ^= seed;
+            }
+        }
+
+        content_hash &update(const void *data, size_t size) {
+            auto p = static_cast<const unsigned char *>(data);
+            length += size;
+            if (buffered) {
+                const size_t take = std::min(size, block_size - buffered);
+                std::memcpy(buffer.data() + buffered, p, take);
+                buffered += take;
+                p += take;
+                size -= take;
+                if (buffered < block_size) {
+                    return *this;
+                }
+                consume_block(buffer.data());
+                buffered = 0;
+            }
+            while (size >= block_size) {
+                consume_block(p);
+                p += block_size;
+                size -= block_size;
+            }
+            std::memcpy(buffer.data(), p, size);
+            buffered = size;
+            return *this;
+        }
+
+        template <typename T>
+        content_hash &update_value(const T &value) {
+            return update(&value, sizeof(T));
+        }
+
+        [[nodiscard]] uint64_t digest() const {
+            auto a = acc;
+            const size_t full_stripes = buffered / stripe_size;
+            for (size_t s = 0; s < full_stripes; ++s) {
+                accumulate(a, buffer.data() + s * stripe_size, s);
+            }
+            // remaining bytes, zero padded, go through one more keyed stripe
+            std::array<unsigned char, stripe_size> tail{};
+            std::memcpy(tail.data(), buffer.data() + full_stripes * stripe_size, buffered - full_stripes * stripe_size);
+            accumulate(a, tail.data(), full_stripes);
+
+            uint64_t result = length * prime64_1;
+            for (size_t i = 0; i < 4; ++i) {
+                result += mul_fold(a[2 * i] ^ secret[2 * i], a[2 * i + 1] ^ secret[2 * i + 1]);
+            }
+            return avalanche(result);
+        }
+
+        static uint64_t of(const void *data, size_t size, uint64_t seed = 0) {
+            return content_hash{seed}.update(data, size).digest();
+        }
+
+    private:
+        static constexpr size_t block_size = stripe_size * stripes_per_block;
+        static constexpr uint64_t prime32_1 = 0x9E3779B1u;
+        static constexpr uint64_t prime32_2 = 0x85EBCA77u;
+        static constexpr uint64_t prime32_3 = 0xC2B2AE3Du;
+        static constexpr uint64_t prime64_1 = 0x9E3779B185EBCA87ull;
+        static constexpr uint64_t prime64_2 = 0xC2B2AE3D27D4EB4Full;
+        static constexpr uint64_t prime64_3 = 0x165667B19E3779F9ull;
+        static constexpr uint64_t prime64_4 = 0x85EBCA77C2B2AE63ull;
+        static constexpr uint64_t prime64_5 = 0x27D4EB2F165667C5ull;
+
+        using acc_t = std::array<uint64_t, 8>;
+
+        // stripe s of a block uses keys secret[s .. s+7]; the scramble uses secret[16 .. 23]
+        static constexpr std::array<uint64_t, 24> secret = [] {
+            std::array<uint64_t, 24> keys{};
+            uint64_t state = prime64_5;
+            for (auto &k: keys) {
+                state += 0x9E3779B97F4A7C15ull;
+                uint64_t z = state;
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+                k = z ^ (z >> 31);
+            }
+            return keys;
+        }();
+
+        static void accumulate(acc_t &a, const unsigned char *stripe, size_t s) {
+            const uint64_t *key = secret.data() + s;
+#if MAXUTILS_SIMD_SSE2
+            for (size_t i = 0; i < 8; i += 2) {
+                const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(stripe + i * 8));
+                const __m128i k = _mm_loadu_si128(reinterpret_cast<const __m128i *>(key + i));
+                const __m128i dk = _mm_xor_si128(d, k);
+                const __m128i product = _mm_mul_epu32(dk, _mm_shuffle_epi32(dk, _MM_SHUFFLE(0, 3, 0, 1)));
+                const __m128i swapped = _mm_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2));
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a.data() + i));
+                v = _mm_add_epi64(v, _mm_add_epi64(product, swapped));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(a.data() + i), v);
+            }
+#elif MAXUTILS_SIMD_NEON
+            for (size_t i = 0; i < 8; i += 2) {
+                const uint64x2_t d = vreinterpretq_u64_u8(vld1q_u8(stripe + i * 8));
+                const uint64x2_t k = vld1q_u64(key + i);
+                const uint64x2_t dk = veorq_u64(d, k);
+                const uint64x2_t product = vmull_u32(vmovn_u64(dk), vshrn_n_u64(dk, 32));
+                const uint64x2_t swapped = vextq_u64(d, d, 1);
+                vst1q_u64(a.data() + i, vaddq_u64(vld1q_u64(a.data() + i), vaddq_u64(product, swapped)));
+            }
+#else
+            for (size_t i = 0; i < 8; ++i) {
+                uint64_t d;
+                std::memcpy(&d, stripe + i * 8, sizeof(d));
+                const uint64_t dk = d ^ key[i];
+                a[i ^ 1] += d;
+                a[i] += (dk & 0xFFFFFFFFu) * (dk >> 32);
+            }
+#endif
+        }
+
+        void consume_block(const unsigned char *block) {
+            for (size_t s = 0; s < stripes_per_block; ++s) {
+                accumulate(acc, block + s * stripe_size, s);
+            }
+            for (size_t i = 0; i < 8; ++i) {
+                acc[i] ^= acc[i] >> 47;
+                acc[i] ^= secret[16 + i];
+                acc[i] *= prime32_1;
+            }
+        }
+
+        static uint64_t mul_fold(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+            const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+            return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+            const uint64_t lo_lo = (a & 0xFFFFFFFFu) * (b & 0xFFFFFFFFu);
+            const uint64_t hi_lo = (a >> 32) * (b & 0xFFFFFFFFu);
+            const uint64_t lo_hi = (a & 0xFFFFFFFFu) * (b >> 32);
+            const uint64_t hi_hi = (a >> 32) * (b >> 32);
+            const uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFu) + lo_hi;
+            const uint64_t upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+            const uint64_t lower = (cross << 32) | (lo_lo & 0xFFFFFFFFu);
+            return lower ^ upper;
+#endif
+        }
+
+        static uint64_t avalanche(uint64_t h) {
+            h ^= h >> 37;
+            h *= 0x165667919E3779F9ull;
+            h ^= h >> 32;
+            return h;
+        }
+
+        acc_t acc;
+        uint64_t length;
+        size_t buffered;
+        std::array<unsigned char, block_size> buffer;
+    };
+
+    inline uint64_t hash_combine(uint64_t seed, uint64_t value) {
+        return seed ^ (value + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2));
+    }
+}
+
+#endif //CONTENT_HASH_HPP
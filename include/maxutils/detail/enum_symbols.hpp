@@ -0,0 +1,106 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef ENUM_SYMBOLS_HPP
+#define ENUM_SYMBOLS_HPP
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "ext_mess.h"
+#include "magic_enum.hpp"
+
+namespace maxutils::detail {
+    using namespace c74::max;
+
+    // Interned symbols for every enumerator, built once per enum type. Max symbols are unique, so lookups
+    // are pointer comparisons rather than string comparisons.
+    template <typename E>
+    class enum_symbols {
+    public:
+        static constexpr size_t count = magic_enum::enum_count<E>();
+
+        static const enum_symbols &get() {
+            static const enum_symbols instance;
+            return instance;
+        }
+
+        [[nodiscard]] t_symbol *to_symbol(E value) const {
+            auto index = magic_enum::enum_index(value);
+            return index ? symbols[*index] : empty;
+        }
+
+        [[nodiscard]] std::optional<E> from_symbol(const t_symbol *s) const {
+            if constexpr (count <= linear_search_limit) {
+                for (size_t i = 0; i < count; ++i) {
+                    if (symbols[i] == s) {
+                        return magic_enum::enum_value<E>(i);
+                    }
+                }
+            } else {
+                auto it = std::lower_bound(sorted.begin(), sorted.end(), s, [](const auto &entry, const t_symbol *s) {
+                    return std::less<const t_symbol *>{}(entry.first, s);
+                });
+                if (it != sorted.end() && it->first == s) {
+                    return magic_enum::enum_value<E>(it->second);
+                }
+            }
+            return std::nullopt;
+        }
+
+        [[nodiscard]] static std::optional<E> from_index(t_atom_long index) {
+            if (index < 0 || static_cast<size_t>(index) >= count) {
+                return std::nullopt;
+            }
+            return magic_enum::enum_value<E>(static_cast<size_t>(index));
+        }
+
+        [[nodiscard]] std::optional<E> from_atom(const t_atom *a) const {
+            switch (atom_gettype(a)) {
+                case A_SYM:
+                    return from_symbol(atom_getsym(a));
+                case A_LONG:
+                case A_FLOAT:
+                    return from_index(atom_getlong(a));
+                default:
+                    return std::nullopt;
+            }
+        }
+
+        // Only used on the error path, so it can afford to allocate.
+        [[nodiscard]] static std::string describe_values() {
+            std::string values;
+            for (auto val: magic_enum::enum_names<E>()) {
+                values += "\"";
+                values += val;
+                values += "\" ";
+            }
+            return values;
+        }
+
+    private:
+        static constexpr size_t linear_search_limit = 8;
+
+        enum_symbols() : empty{gensym("")} {
+            const auto names = magic_enum::enum_names<E>();
+            for (size_t i = 0; i < count; ++i) {
+                symbols[i] = gensym(std::string(names[i]).c_str());
+                sorted[i] = {symbols[i], i};
+            }
+            std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+                return std::less<const t_symbol *>{}(a.first, b.first);
+            });
+        }
+
+        std::array<t_symbol *, count> symbols{};
+        std::array<std::pair<const t_symbol *, size_t>, count> sorted{};
+        t_symbol *empty;
+    };
+}
+
+#endif //ENUM_SYMBOLS_HPP
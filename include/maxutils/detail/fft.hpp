@@ -0,0 +1,93 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef FFT_HPP
+#define FFT_HPP
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <numbers>
+#include <utility>
+#include <vector>
+
+namespace maxutils::detail {
+    inline size_t next_pow2(size_t n) {
+        size_t p = 1;
+        while (p < n) {
+            p <<= 1;
+        }
+        return p;
+    }
+
+    // In-place iterative radix-2 FFT for one power-of-two size, with its bit-reversal table and twiddles
+    // computed once. The inverse is unscaled.
+    class fft_plan {
+    public:
+        fft_plan() = default;
+
+        explicit fft_plan(size_t n) : n{n}, reversed(n), twiddles(n / 2) {
+            size_t bits = 0;
+            while ((size_t{1} << bits) < n) {
+                ++bits;
+            }
+            for (size_t i = 0; i < n; ++i) {
+                size_t r = 0;
+                for (size_t b = 0; b < bits; ++b) {
+                    r |= ((i >> b) & 1) << (bits - 1 - b);
+                }
+                reversed[i] = r;
+            }
+            for (size_t i = 0; i < n / 2; ++i) {
+                const double angle = -2.0 * std::numbers::pi * static_cast<double>(i) / static_cast<double>(n);
+                twiddles[i] = {static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle))};
+            }
+        }
+
+        [[nodiscard]] size_t size() const {
+            return n;
+        }
+
+        void forward(std::complex<float> *data) const {
+            run(data, false);
+        }
+
+        void inverse(std::complex<float> *data) const {
+            run(data, true);
+        }
+
+    private:
+        void run(std::complex<float> *data, bool inverse) const {
+            for (size_t i = 0; i < n; ++i) {
+                if (i < reversed[i]) {
+                    std::swap(data[i], data[reversed[i]]);
+                }
+            }
+            for (size_t len = 2; len <= n; len <<= 1) {
+                const size_t half = len / 2;
+                const size_t step = n / len;
+                for (size_t start = 0; start < n; start += len) {
+                    for (size_t k = 0; k < half; ++k) {
+                        auto w = twiddles[k * step];
+                        if (inverse) {
+                            w = std::conj(w);
+                        }
+                        // written out rather than std::complex operator* to skip its NaN/inf handling
+                        const auto &b = data[start + k + half];
+                        const std::complex<float> t{w.real() * b.real() - w.imag() * b.imag(),
+                                                    w.real() * b.imag() + w.imag() * b.real()};
+                        data[start + k + half] = data[start + k] - t;
+                        data[start + k] += t;
+                    }
+                }
+            }
+        }
+
+        size_t n = 0;
+        std::vector<size_t> reversed;
+        std::vector<std::complex<float>> twiddles;
+    };
+}
+
+#endif //FFT_HPP
@@ -14,6 +14,9 @@ namespace maxutils::detail {
     struct fixed_string {
         std::array<char, N> data;
 
+        constexpr fixed_string() noexcept : data{} {
+        }
+
         constexpr fixed_string(const char (&str)[N]) noexcept {
             for (std::size_t i = 0; i < N; ++i) {
                 data[i] = str[i];
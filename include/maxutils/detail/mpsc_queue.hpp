@@ -0,0 +1,85 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef MPSC_QUEUE_HPP
+#define MPSC_QUEUE_HPP
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+
+namespace maxutils::detail {
+    // Bounded lock-free queue for many producers and a single consumer (Vyukov's bounded queue).
+    // Slots are allocated once up front and filled/read in place, so nothing is allocated or copied
+    // twice on the hot path.
+    template <typename T>
+    class mpsc_queue {
+    public:
+        explicit mpsc_queue(size_t capacity)
+            : mask{std::bit_ceil(capacity < 2 ? size_t{2} : capacity) - 1}, cells{std::make_unique<cell[]>(mask + 1)} {
+            for (size_t i = 0; i <= mask; ++i) {
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        mpsc_queue(const mpsc_queue &) = delete;
+        mpsc_queue &operator=(const mpsc_queue &) = delete;
+
+        // fill(T &) writes the element in place; returns false if the queue is full
+        template <typename Fill>
+        bool try_push(Fill &&fill) {
+            size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+            cell *c;
+            for (;;) {
+                c = &cells[pos & mask];
+                const size_t seq = c->sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+                if (diff == 0) {
+                    if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = enqueue_pos.load(std::memory_order_relaxed);
+                }
+            }
+            fill(c->value);
+            c->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // consume(T &) reads the element in place; returns false if the queue is empty
+        template <typename Consume>
+        bool try_pop(Consume &&consume) {
+            cell &c = cells[dequeue_pos & mask];
+            const size_t seq = c.sequence.load(std::memory_order_acquire);
+            if (static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(dequeue_pos + 1) < 0) {
+                return false;
+            }
+            consume(c.value);
+            c.sequence.store(dequeue_pos + mask + 1, std::memory_order_release);
+            ++dequeue_pos;
+            return true;
+        }
+
+        [[nodiscard]] size_t capacity() const {
+            return mask + 1;
+        }
+
+    private:
+        struct cell {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+
+        const size_t mask;
+        std::unique_ptr<cell[]> cells;
+        alignas(64) std::atomic<size_t> enqueue_pos{0};
+        alignas(64) size_t dequeue_pos{0};
+    };
+}
+
+#endif //MPSC_QUEUE_HPP
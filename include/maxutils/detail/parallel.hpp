@@ -0,0 +1,178 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ext.h"
+
+namespace maxutils::detail {
+    // Persistent pool that splits a range of rows into chunks and works through them on every core,
+    // including the calling thread. Only one range runs at a time: calls made while the pool is busy
+    // (from another thread, or nested inside a chunk) simply run serially on the caller.
+    //
+    // There is one pool per process, not per external: the first external to ask creates it and leaves it in
+    // a symbol's s_thing for the others, so loading several doesn't start a thread per core for each of them.
+    // Bump the version in the symbol name whenever the layout of this class changes.
+    class thread_pool {
+    public:
+        static thread_pool &get() {
+            static thread_pool &instance = shared();
+            return instance;
+        }
+
+        thread_pool(const thread_pool &) = delete;
+        thread_pool &operator=(const thread_pool &) = delete;
+
+        ~thread_pool() {
+            {
+                std::lock_guard lock{mutex};
+                quit = true;
+            }
+            wake.notify_all();
+            for (auto &t: workers) {
+                t.join();
+            }
+        }
+
+        [[nodiscard]] size_t concurrency() const {
+            return workers.size() + 1;
+        }
+
+        // fn(begin, end) is called for consecutive chunks of at least `grain` rows covering [begin, end).
+        template <typename Fn>
+        void parallel_for(size_t begin, size_t end, size_t grain, Fn &&fn) {
+            if (end <= begin) {
+                return;
+            }
+            grain = std::max<size_t>(grain, 1);
+            const size_t count = end - begin;
+            std::unique_lock busy{run_mutex, std::try_to_lock};
+            if (workers.empty() || count <= grain || in_pool_thread() || !busy.owns_lock()) {
+                fn(begin, end);
+                return;
+            }
+
+            const size_t chunks = std::min(count / grain, concurrency() * 4);
+            job_state state{
+                .invoke = [](void *f, size_t b, size_t e) { (*static_cast<std::remove_reference_t<Fn> *>(f))(b, e); },
+                .fn = &fn,
+                .begin = begin,
+                .count = count,
+                .chunks = chunks,
+            };
+            {
+                std::lock_guard lock{mutex};
+                job = &state;
+                ++generation;
+            }
+            wake.notify_all();
+
+            in_pool_thread() = true;
+            work(state);
+            in_pool_thread() = false;
+
+            // wait for every chunk, and for every worker that picked the job up to let go of it
+            std::unique_lock lock{mutex};
+            done.wait(lock, [&state] {
+                return state.finished.load(std::memory_order_acquire) == state.chunks && state.active == 0;
+            });
+            job = nullptr;
+        }
+
+    private:
+        struct job_state {
+            void (*invoke)(void *, size_t, size_t);
+            void *fn;
+            size_t begin;
+            size_t count;
+            size_t chunks;
+            std::atomic<size_t> next{0};
+            std::atomic<size_t> finished{0};
+            size_t active = 0; // guarded by mutex
+        };
+
+        // Never deleted: the workers may be running code from any external until Max quits.
+        static thread_pool &shared() {
+            c74::max::t_symbol *name = c74::max::gensym("__maxutils_thread_pool_v1");
+            c74::max::critical_enter(nullptr);
+            if (!name->s_thing) {
+                name->s_thing = reinterpret_cast<c74::max::t_object *>(new thread_pool);
+            }
+            c74::max::critical_exit(nullptr);
+            return *reinterpret_cast<thread_pool *>(name->s_thing);
+        }
+
+        thread_pool() {
+            const unsigned n = std::max(1u, std::thread::hardware_concurrency());
+            for (unsigned i = 1; i < n; ++i) {
+                workers.emplace_back([this] { run(); });
+            }
+        }
+
+        static bool &in_pool_thread() {
+            static thread_local bool flag = false;
+            return flag;
+        }
+
+        void work(job_state &state) {
+            for (;;) {
+                const size_t chunk = state.next.fetch_add(1, std::memory_order_relaxed);
+                if (chunk >= state.chunks) {
+                    return;
+                }
+                const size_t b = state.begin + chunk * state.count / state.chunks;
+                const size_t e = state.begin + (chunk + 1) * state.count / state.chunks;
+                state.invoke(state.fn, b, e);
+                state.finished.fetch_add(1, std::memory_order_acq_rel);
+            }
+        }
+
+        void run() {
+            in_pool_thread() = true;
+            size_t seen = 0;
+            std::unique_lock lock{mutex};
+            for (;;) {
+                wake.wait(lock, [&] { return quit || (job && generation != seen); });
+                if (quit) {
+                    return;
+                }
+                seen = generation;
+                job_state *state = job;
+                ++state->active;
+                lock.unlock();
+                work(*state);
+                lock.lock();
+                --state->active;
+                done.notify_all();
+            }
+        }
+
+        std::mutex run_mutex;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable done;
+        job_state *job = nullptr;
+        size_t generation = 0;
+        bool quit = false;
+        std::vector<std::thread> workers;
+    };
+
+    template <typename Fn>
+    void parallel_for(size_t begin, size_t end, size_t grain, Fn &&fn) {
+        thread_pool::get().parallel_for(begin, end, grain, std::forward<Fn>(fn));
+    }
+}
+
+#endif //PARALLEL_HPP
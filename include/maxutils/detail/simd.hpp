@@ -0,0 +1,284 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MAXUTILS_SIMD_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MAXUTILS_SIMD_NEON 1
+#endif
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace maxutils::detail {
+    // Four packed floats. Externals are built for both x86_64 and arm64, so this only uses what every
+    // target has (SSE2 / NEON) and falls back to plain arrays elsewhere.
+    struct f32x4 {
+#if MAXUTILS_SIMD_SSE2
+        __m128 v;
+
+        static f32x4 load(const float *p) { return {_mm_loadu_ps(p)}; }
+        static f32x4 set1(float x) { return {_mm_set1_ps(x)}; }
+        static f32x4 set(float a, float b, float c, float d) { return {_mm_setr_ps(a, b, c, d)}; }
+        static f32x4 zero() { return {_mm_setzero_ps()}; }
+        void store(float *p) const { _mm_storeu_ps(p, v); }
+
+        friend f32x4 operator+(f32x4 a, f32x4 b) { return {_mm_add_ps(a.v, b.v)}; }
+        friend f32x4 operator-(f32x4 a, f32x4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+        friend f32x4 operator*(f32x4 a, f32x4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+        friend f32x4 operator/(f32x4 a, f32x4 b) { return {_mm_div_ps(a.v, b.v)}; }
+        friend f32x4 min(f32x4 a, f32x4 b) { return {_mm_min_ps(a.v, b.v)}; }
+        friend f32x4 max(f32x4 a, f32x4 b) { return {_mm_max_ps(a.v, b.v)}; }
+        friend f32x4 sqrt(f32x4 a) { return {_mm_sqrt_ps(a.v)}; }
+        // a > b ? t : f, per lane
+        friend f32x4 select_gt(f32x4 a, f32x4 b, f32x4 t, f32x4 f) {
+            const __m128 m = _mm_cmpgt_ps(a.v, b.v);
+            return {_mm_or_ps(_mm_and_ps(m, t.v), _mm_andnot_ps(m, f.v))};
+        }
+        friend f32x4 select_eq(f32x4 a, f32x4 b, f32x4 t, f32x4 f) {
+            const __m128 m = _mm_cmpeq_ps(a.v, b.v);
+            return {_mm_or_ps(_mm_and_ps(m, t.v), _mm_andnot_ps(m, f.v))};
+        }
+        // towards zero, for values within int32 range
+        friend f32x4 truncate(f32x4 a) { return {_mm_cvtepi32_ps(_mm_cvttps_epi32(a.v))}; }
+#elif MAXUTILS_SIMD_NEON
+        float32x4_t v;
+
+        static f32x4 load(const float *p) { return {vld1q_f32(p)}; }
+        static f32x4 set1(float x) { return {vdupq_n_f32(x)}; }
+        static f32x4 set(float a, float b, float c, float d) {
+            const float tmp[4] = {a, b, c, d};
+            return {vld1q_f32(tmp)};
+        }
+        static f32x4 zero() { return {vdupq_n_f32(0.0f)}; }
+        void store(float *p) const { vst1q_f32(p, v); }
+
+        friend f32x4 operator+(f32x4 a, f32x4 b) { return {vaddq_f32(a.v, b.v)}; }
+        friend f32x4 operator-(f32x4 a, f32x4 b) { return {vsubq_f32(a.v, b.v)}; }
+        friend f32x4 operator*(f32x4 a, f32x4 b) { return {vmulq_f32(a.v, b.v)}; }
+        friend f32x4 operator/(f32x4 a, f32x4 b) { return {vdivq_f32(a.v, b.v)}; }
+        friend f32x4 min(f32x4 a, f32x4 b) { return {vminq_f32(a.v, b.v)}; }
+        friend f32x4 max(f32x4 a, f32x4 b) { return {vmaxq_f32(a.v, b.v)}; }
+        friend f32x4 sqrt(f32x4 a) { return {vsqrtq_f32(a.v)}; }
+        friend f32x4 select_gt(f32x4 a, f32x4 b, f32x4 t, f32x4 f) { return {vbslq_f32(vcgtq_f32(a.v, b.v), t.v, f.v)}; }
+        friend f32x4 select_eq(f32x4 a, f32x4 b, f32x4 t, f32x4 f) { return {vbslq_f32(vceqq_f32(a.v, b.v), t.v, f.v)}; }
+        friend f32x4 truncate(f32x4 a) { return {vcvtq_f32_s32(vcvtq_s32_f32(a.v))}; }
+#else
+        float v[4];
+
+        static f32x4 load(const float *p) { return {{p[0], p[1], p[2], p[3]}}; }
+        static f32x4 set1(float x) { return {{x, x, x, x}}; }
+        static f32x4 set(float a, float b, float c, float d) { return {{a, b, c, d}}; }
+        static f32x4 zero() { return set1(0.0f); }
+        void store(float *p) const {
+            for (int i = 0; i < 4; ++i) p[i] = v[i];
+        }
+
+        friend f32x4 operator+(f32x4 a, f32x4 b) { return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}}; }
+        friend f32x4 operator-(f32x4 a, f32x4 b) { return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}}; }
+        friend f32x4 operator*(f32x4 a, f32x4 b) { return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}}; }
+        friend f32x4 operator/(f32x4 a, f32x4 b) { return {{a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3]}}; }
+        friend f32x4 sqrt(f32x4 a) { return {{std::sqrt(a.v[0]), std::sqrt(a.v[1]), std::sqrt(a.v[2]), std::sqrt(a.v[3])}}; }
+        friend f32x4 min(f32x4 a, f32x4 b) {
+            return {{a.v[0] < b.v[0] ? a.v[0] : b.v[0], a.v[1] < b.v[1] ? a.v[1] : b.v[1],
+                     a.v[2] < b.v[2] ? a.v[2] : b.v[2], a.v[3] < b.v[3] ? a.v[3] : b.v[3]}};
+        }
+        friend f32x4 max(f32x4 a, f32x4 b) {
+            return {{a.v[0] > b.v[0] ? a.v[0] : b.v[0], a.v[1] > b.v[1] ? a.v[1] : b.v[1],
+                     a.v[2] > b.v[2] ? a.v[2] : b.v[2], a.v[3] > b.v[3] ? a.v[3] : b.v[3]}};
+        }
+        friend f32x4 select_gt(f32x4 a, f32x4 b, f32x4 t, f32x4 f) {
+            return {{a.v[0] > b.v[0] ? t.v[0] : f.v[0], a.v[1] > b.v[1] ? t.v[1] : f.v[1],
+                     a.v[2] > b.v[2] ? t.v[2] : f.v[2], a.v[3] > b.v[3] ? t.v[3] : f.v[3]}};
+        }
+        friend f32x4 select_eq(f32x4 a, f32x4 b, f32x4 t, f32x4 f) {
+            return {{a.v[0] == b.v[0] ? t.v[0] : f.v[0], a.v[1] == b.v[1] ? t.v[1] : f.v[1],
+                     a.v[2] == b.v[2] ? t.v[2] : f.v[2], a.v[3] == b.v[3] ? t.v[3] : f.v[3]}};
+        }
+        friend f32x4 truncate(f32x4 a) { return {{std::trunc(a.v[0]), std::trunc(a.v[1]), std::trunc(a.v[2]), std::trunc(a.v[3])}}; }
+#endif
+        // a + b * c
+        friend f32x4 fma(f32x4 a, f32x4 b, f32x4 c) { return a + b * c; }
+    };
+
+    // Eight packed uint16s with wrapping add/sub, e.g. for histogram counts.
+    struct u16x8 {
+#if MAXUTILS_SIMD_SSE2
+        __m128i v;
+
+        static u16x8 load(const uint16_t *p) { return {_mm_loadu_si128(reinterpret_cast<const __m128i *>(p))}; }
+        void store(uint16_t *p) const { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v); }
+
+        friend u16x8 operator+(u16x8 a, u16x8 b) { return {_mm_add_epi16(a.v, b.v)}; }
+        friend u16x8 operator-(u16x8 a, u16x8 b) { return {_mm_sub_epi16(a.v, b.v)}; }
+#elif MAXUTILS_SIMD_NEON
+        uint16x8_t v;
+
+        static u16x8 load(const uint16_t *p) { return {vld1q_u16(p)}; }
+        void store(uint16_t *p) const { vst1q_u16(p, v); }
+
+        friend u16x8 operator+(u16x8 a, u16x8 b) { return {vaddq_u16(a.v, b.v)}; }
+        friend u16x8 operator-(u16x8 a, u16x8 b) { return {vsubq_u16(a.v, b.v)}; }
+#else
+        uint16_t v[8];
+
+        static u16x8 load(const uint16_t *p) {
+            u16x8 r;
+            for (int i = 0; i < 8; ++i) r.v[i] = p[i];
+            return r;
+        }
+        void store(uint16_t *p) const {
+            for (int i = 0; i < 8; ++i) p[i] = v[i];
+        }
+
+        friend u16x8 operator+(u16x8 a, u16x8 b) {
+            for (int i = 0; i < 8; ++i) a.v[i] = static_cast<uint16_t>(a.v[i] + b.v[i]);
+            return a;
+        }
+        friend u16x8 operator-(u16x8 a, u16x8 b) {
+            for (int i = 0; i < 8; ++i) a.v[i] = static_cast<uint16_t>(a.v[i] - b.v[i]);
+            return a;
+        }
+#endif
+    };
+
+    // In-register 4x4 transpose: rows a..d become columns. Only moves lanes, so it's also fine for any 32-bit
+    // data loaded as floats.
+    inline void transpose4(f32x4 &a, f32x4 &b, f32x4 &c, f32x4 &d) {
+#if MAXUTILS_SIMD_SSE2
+        _MM_TRANSPOSE4_PS(a.v, b.v, c.v, d.v);
+#elif MAXUTILS_SIMD_NEON
+        const float32x4x2_t ab = vtrnq_f32(a.v, b.v), cd = vtrnq_f32(c.v, d.v);
+        a.v = vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0]));
+        b.v = vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1]));
+        c.v = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+        d.v = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
+#else
+        f32x4 *rows[4] = {&a, &b, &c, &d};
+        for (int i = 0; i < 4; ++i) {
+            for (int j = i + 1; j < 4; ++j) {
+                std::swap(rows[i]->v[j], rows[j]->v[i]);
+            }
+        }
+#endif
+    }
+
+    // Lanes in reverse order.
+    inline f32x4 reverse(f32x4 a) {
+#if MAXUTILS_SIMD_SSE2
+        return {_mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(0, 1, 2, 3))};
+#elif MAXUTILS_SIMD_NEON
+        const float32x4_t r = vrev64q_f32(a.v);
+        return {vcombine_f32(vget_high_f32(r), vget_low_f32(r))};
+#else
+        return f32x4::set(a.v[3], a.v[2], a.v[1], a.v[0]);
+#endif
+    }
+
+    // Loads 4 interleaved N-component vectors (x0 y0 z0 x1 y1 z1 ...) as N vectors of one component each.
+    template <size_t N>
+    void load_deinterleaved(const float *p, f32x4 (&out)[N]) {
+        static_assert(N >= 2 && N <= 4);
+#if MAXUTILS_SIMD_SSE2
+        if constexpr (N == 2) {
+            const __m128 a = _mm_loadu_ps(p), b = _mm_loadu_ps(p + 4);
+            out[0].v = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            out[1].v = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        } else if constexpr (N == 3) {
+            // a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+            const __m128 a = _mm_loadu_ps(p), b = _mm_loadu_ps(p + 4), c = _mm_loadu_ps(p + 8);
+            const __m128 x23 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2));
+            out[0].v = _mm_shuffle_ps(a, x23, _MM_SHUFFLE(2, 0, 3, 0));
+            const __m128 y01 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));
+            const __m128 y23 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3));
+            out[1].v = _mm_shuffle_ps(y01, y23, _MM_SHUFFLE(2, 0, 2, 0));
+            const __m128 z01 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));
+            out[2].v = _mm_shuffle_ps(z01, c, _MM_SHUFFLE(3, 0, 2, 0));
+        } else {
+            __m128 a = _mm_loadu_ps(p), b = _mm_loadu_ps(p + 4), c = _mm_loadu_ps(p + 8), d = _mm_loadu_ps(p + 12);
+            _MM_TRANSPOSE4_PS(a, b, c, d);
+            out[0].v = a;
+            out[1].v = b;
+            out[2].v = c;
+            out[3].v = d;
+        }
+#elif MAXUTILS_SIMD_NEON
+        if constexpr (N == 2) {
+            const float32x4x2_t v = vld2q_f32(p);
+            out[0].v = v.val[0];
+            out[1].v = v.val[1];
+        } else if constexpr (N == 3) {
+            const float32x4x3_t v = vld3q_f32(p);
+            out[0].v = v.val[0];
+            out[1].v = v.val[1];
+            out[2].v = v.val[2];
+        } else {
+            const float32x4x4_t v = vld4q_f32(p);
+            out[0].v = v.val[0];
+            out[1].v = v.val[1];
+            out[2].v = v.val[2];
+            out[3].v = v.val[3];
+        }
+#else
+        for (size_t c = 0; c < N; ++c) {
+            out[c] = f32x4::set(p[c], p[N + c], p[2 * N + c], p[3 * N + c]);
+        }
+#endif
+    }
+
+    // Inverse of load_deinterleaved.
+    template <size_t N>
+    void store_interleaved(float *p, const f32x4 (&in)[N]) {
+        static_assert(N >= 2 && N <= 4);
+#if MAXUTILS_SIMD_SSE2
+        if constexpr (N == 2) {
+            _mm_storeu_ps(p, _mm_unpacklo_ps(in[0].v, in[1].v));
+            _mm_storeu_ps(p + 4, _mm_unpackhi_ps(in[0].v, in[1].v));
+        } else if constexpr (N == 3) {
+            const __m128 x = in[0].v, y = in[1].v, z = in[2].v;
+            const __m128 x0y0 = _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0));
+            const __m128 z0x1 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0));
+            _mm_storeu_ps(p, _mm_shuffle_ps(x0y0, z0x1, _MM_SHUFFLE(2, 0, 2, 0)));
+            const __m128 y1z1 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1));
+            const __m128 x2y2 = _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2));
+            _mm_storeu_ps(p + 4, _mm_shuffle_ps(y1z1, x2y2, _MM_SHUFFLE(2, 0, 2, 0)));
+            const __m128 z2x3 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2));
+            const __m128 y3z3 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3));
+            _mm_storeu_ps(p + 8, _mm_shuffle_ps(z2x3, y3z3, _MM_SHUFFLE(2, 0, 2, 0)));
+        } else {
+            __m128 a = in[0].v, b = in[1].v, c = in[2].v, d = in[3].v;
+            _MM_TRANSPOSE4_PS(a, b, c, d);
+            _mm_storeu_ps(p, a);
+            _mm_storeu_ps(p + 4, b);
+            _mm_storeu_ps(p + 8, c);
+            _mm_storeu_ps(p + 12, d);
+        }
+#elif MAXUTILS_SIMD_NEON
+        if constexpr (N == 2) {
+            vst2q_f32(p, float32x4x2_t{{in[0].v, in[1].v}});
+        } else if constexpr (N == 3) {
+            vst3q_f32(p, float32x4x3_t{{in[0].v, in[1].v, in[2].v}});
+        } else {
+            vst4q_f32(p, float32x4x4_t{{in[0].v, in[1].v, in[2].v, in[3].v}});
+        }
+#else
+        for (size_t c = 0; c < N; ++c) {
+            float lanes[4];
+            in[c].store(lanes);
+            for (size_t i = 0; i < 4; ++i) {
+                p[i * N + c] = lanes[i];
+            }
+        }
+#endif
+    }
+}
+
+#endif //SIMD_HPP
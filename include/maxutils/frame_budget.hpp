@@ -0,0 +1,199 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef FRAME_BUDGET_HPP
+#define FRAME_BUDGET_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ext.h"
+#include "attributes.hpp"
+#include "detail/clock.hpp"
+#include "detail/member_pointer.hpp"
+
+namespace maxutils {
+    using namespace c74::max;
+
+    // Keeps a per-frame kernel inside a time budget by trading quality for time. Each frame is measured (wrap
+    // matrix_calc's work in measure()), the next frame's cost is predicted at every quality level and the
+    // level drops as soon as the current one is predicted to overrun. It climbs back one level at a time, once
+    // the level above has been predicted to fit with some headroom for a run of frames, so it doesn't
+    // oscillate around the target.
+    //
+    // Level 0 is full quality; level n processes at scale(n) of the full resolution, e.g. by resampling into
+    // an internal matrix sized with fit(), and optional stages can be skipped with stage_enabled(). A target of
+    // 0 disables the controller. All-zero memory is a valid, disabled controller, so it can sit inside an
+    // object_alloc'ed struct.
+    //
+    //     auto frame = x->budget.measure();
+    //     if (x->budget.level_changed()) {
+    //         x->budget.fit(x->work, {in_info.dim[0], in_info.dim[1]});
+    //     }
+    //     resample(in, work); process(work); resample(work, out);
+    //     if (x->budget.stage_enabled(1)) { bloom(out); }
+    class frame_budget {
+    public:
+        static constexpr int level_count = 5;
+        static constexpr std::array<double, level_count> scales{1.0, 0.75, 0.5, 0.375, 0.25};
+
+        class frame {
+        public:
+            explicit frame(frame_budget &budget) : budget{budget}, start{detail::now_ns()} {
+            }
+
+            ~frame() {
+                budget.record(detail::now_ns() - start);
+            }
+
+            frame(const frame &) = delete;
+            frame &operator=(const frame &) = delete;
+
+        private:
+            frame_budget &budget;
+            uint64_t start;
+        };
+
+        [[nodiscard]] frame measure() {
+            return frame{*this};
+        }
+
+        // Feeds one frame's time at the current level to the estimate and picks the level for the next one.
+        void record(uint64_t ns) {
+            const int current = level();
+            // cost is modelled as proportional to the pixel count, so frames at any level update one estimate
+            const double sample = static_cast<double>(ns) / cost_factor(current);
+            if (samples == 0) {
+                mean = sample;
+                deviation = sample / 2;
+            } else {
+                deviation += (std::abs(sample - mean) - deviation) / 4;
+                mean += (sample - mean) / 8;
+            }
+            ++samples;
+            changed = false;
+
+            const auto target = static_cast<double>(target_ns.load(std::memory_order_relaxed));
+            int next = current;
+            if (target == 0) {
+                next = 0;
+                calm_frames = 0;
+            } else if (predicted_ns(current) > target) {
+                while (next + 1 < level_count && predicted_ns(next) > target) {
+                    ++next;
+                }
+                calm_frames = 0;
+            } else if (current > 0 && predicted_ns(current - 1) <= target * up_headroom) {
+                if (++calm_frames >= up_frames) {
+                    next = current - 1;
+                    calm_frames = 0;
+                }
+            } else {
+                calm_frames = 0;
+            }
+            if (next != current) {
+                current_level.store(next, std::memory_order_relaxed);
+                changed = true;
+            }
+        }
+
+        // Expected cost of the next frame at the given level: the mean plus twice the mean deviation of recent
+        // frames, scaled to that level's pixel count.
+        [[nodiscard]] double predicted_ns(int at) const {
+            return (mean + 2 * deviation) * cost_factor(at);
+        }
+
+        [[nodiscard]] int level() const {
+            return current_level.load(std::memory_order_relaxed);
+        }
+
+        // True for the frame after the level changed, i.e. when internal buffers need resizing.
+        [[nodiscard]] bool level_changed() const {
+            return changed;
+        }
+
+        [[nodiscard]] double scale() const {
+            return scales[level()];
+        }
+
+        // Optional stages run while the level is at most max_level.
+        [[nodiscard]] bool stage_enabled(int max_level) const {
+            return level() <= max_level;
+        }
+
+        [[nodiscard]] std::vector<long> scaled_dims(std::vector<long> dims) const {
+            const double s = scale();
+            for (auto &d: dims) {
+                d = std::max(1l, std::lround(d * s));
+            }
+            return dims;
+        }
+
+        // Sizes an internal matrix (NamedMatrix or anything with set_dims) for the current level.
+        template <typename Matrix>
+        t_jit_err fit(Matrix &matrix, const std::vector<long> &full_dims) const {
+            return matrix.set_dims(scaled_dims(full_dims));
+        }
+
+        // Milliseconds per frame; 0 turns the controller off and goes back to full quality.
+        void set_target_ms(double ms) {
+            target_ns.store(static_cast<uint64_t>(std::max(0.0, ms) * 1e6), std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] double target_ms() const {
+            return target_ns.load(std::memory_order_relaxed) / 1e6;
+        }
+
+        // Forgets the measurements, e.g. when the input size changes, and returns to full quality.
+        void reset() {
+            mean = deviation = 0;
+            samples = 0;
+            calm_frames = 0;
+            changed = level() != 0;
+            current_level.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        static constexpr double up_headroom = 0.8;
+        static constexpr uint32_t up_frames = 30;
+
+        static constexpr double cost_factor(int at) {
+            return scales[at] * scales[at];
+        }
+
+        double mean = 0;
+        double deviation = 0;
+        uint64_t samples = 0;
+        std::atomic<uint64_t> target_ns{0};
+        std::atomic<int> current_level{0};
+        uint32_t calm_frames = 0;
+        bool changed = false;
+    };
+
+    // Registers <prefix> (the target in milliseconds, 0 for off) and a read-only <prefix>_quality level
+    // (0 is full quality).
+    template <auto budget_ptr>
+    void create_budget_attrs(t_class *c, const std::string &prefix = "budget") {
+        using object_t = detail::member_pointer_object_type_t<budget_ptr>;
+        create_attr(c, prefix, [](object_t *x) -> double {
+            return (x->*budget_ptr).target_ms();
+        }, [](object_t *x, double ms) -> err_t {
+            (x->*budget_ptr).set_target_ms(ms);
+            return MAX_ERR_NONE;
+        });
+        create_attr(c, prefix + "_quality", [](object_t *x) -> long {
+            return (x->*budget_ptr).level();
+        }, +[](object_t *x, long) -> err_t {
+            object_error((t_object *) x, "Quality level is read-only");
+            return MAX_ERR_GENERIC;
+        }).readonly();
+    }
+}
+
+#endif //FRAME_BUDGET_HPP
@@ -10,6 +10,7 @@
 #include <concepts>
 #include "c74_jitter.h"
 #include <numeric>
+#include "tracer.hpp"
 
 namespace maxutils {
     using namespace c74::max;
@@ -106,6 +107,7 @@ namespace maxutils {
 
     template <size_t N>
     class MatrixLock {
+        trace_scope span{"MatrixLock", "matrix"};
         std::pair<t_object *, long> matrices_with_locks[N];
 
     public:
@@ -141,6 +143,20 @@ namespace maxutils {
         }(std::make_integer_sequence<long, I>{});
     }
 
+    // Resizes dst to match src and copies the data across, as jit_mop_ioproc_copy_adapt does.
+    inline t_jit_err jit_matrix_copy_adapt(t_object *dst, t_object *src) {
+        t_jit_matrix_info info;
+        auto err = (t_jit_err) jit_object_method(src, _jit_sym_getinfo, &info);
+        if (err) {
+            return err;
+        }
+        err = (t_jit_err) jit_object_method(dst, _jit_sym_setinfo, &info);
+        if (err) {
+            return err;
+        }
+        return (t_jit_err) jit_object_method(dst, _jit_sym_frommatrix, src, nullptr);
+    }
+
     t_jit_err jit_matrix_set_type(t_object *matrix, t_symbol *type) {
         t_jit_matrix_info info;
         jit_object_method(matrix, _jit_sym_getinfo, &info);
@@ -7,6 +7,7 @@
 
 #include "c74_jitter.h"
 #include "jit_type_sym.hpp"
+#include "tracer.hpp"
 #include <span>
 #include <cassert>
 
@@ -51,6 +52,7 @@ namespace maxutils {
     class jit_matrix_view {
     public:
         explicit jit_matrix_view(t_jit_object *matrix) : matrix{matrix} {
+            trace_scope span{"getdata", "matrix"};
             jit_object_method(matrix, _jit_sym_getinfo, &info);
             jit_object_method(matrix, _jit_sym_getdata, &data);
         }
@@ -59,12 +61,22 @@ namespace maxutils {
         std::span<T> row(size_t i) {
             assert(info.type == type_sym<T>::value());
             assert(info.planecount == extent_v<T>);
-            assert(info.dimcount == 2);
+            assert(info.dimcount == 2 || (info.dimcount == 1 && i == 0));
             assert(data != nullptr);
             T *p = reinterpret_cast<T *>(data + i * info.dimstride[1]);
             return {p, static_cast<size_t>(info.dim[0])};
         }
 
+        // The whole row as one flat span of cols * planecount values, for matrices whose planecount is only
+        // known at runtime.
+        template <typename T>
+        std::span<T> plane_row(size_t i) {
+            assert(info.type == type_sym<T>::value());
+            assert(data != nullptr);
+            T *p = reinterpret_cast<T *>(data + i * info.dimstride[1]);
+            return {p, static_cast<size_t>(info.dim[0] * info.planecount)};
+        }
+
         template <typename T>
         T &at(std::convertible_to<long> auto ...indices) {
             assert(info.type == type_sym<T>::value());
@@ -98,6 +110,14 @@ namespace maxutils {
             return info.planecount;
         }
 
+        t_symbol *type() const {
+            return info.type;
+        }
+
+        long dimcount() const {
+            return info.dimcount;
+        }
+
         t_jit_err set_dims(std::convertible_to<long> auto ...dims) {
             int i = 0;
             for (auto dim : {dims...}) {
@@ -7,7 +7,11 @@
 
 #include "c74_jitter.h"
 #include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <span>
+#include "tracer.hpp"
 
 namespace maxutils {
     using namespace c74::max;
@@ -137,6 +141,7 @@ namespace maxutils {
     class matrix_view {
     public:
         explicit matrix_view(t_object *matrix) : info{}, data{}, matrix{matrix} {
+            trace_scope span{"getdata", "matrix"};
             jit_object_method(matrix, _jit_sym_getdata, &data);
             if (data == nullptr) {
                 throw std::runtime_error("Invalid data");
@@ -147,6 +152,18 @@ namespace maxutils {
             }
         }
 
+        // For when the caller already has the matrix's info, e.g. after dispatching on it.
+        matrix_view(t_object *matrix, const t_jit_matrix_info &info) : info{info}, data{}, matrix{matrix} {
+            trace_scope span{"getdata", "matrix"};
+            jit_object_method(matrix, _jit_sym_getdata, &data);
+            if (data == nullptr) {
+                throw std::runtime_error("Invalid data");
+            }
+            if (info.type != type_sym<T>()) {
+                throw std::runtime_error("Type mismatch");
+            }
+        }
+
         row_view<T> row(size_t i) {
             return {
                 reinterpret_cast<T *>(data + i * info.dimstride[1]),
@@ -171,6 +188,18 @@ namespace maxutils {
             return info.planecount;
         }
 
+        [[nodiscard]] const t_jit_matrix_info &matrix_info() const {
+            return info;
+        }
+
+        [[nodiscard]] const char *raw_data() const {
+            return data;
+        }
+
+        [[nodiscard]] long dimcount() const {
+            return info.dimcount;
+        }
+
         [[nodiscard]] long dim(long i) const {
             return info.dim[i];
         }
@@ -183,8 +212,50 @@ namespace maxutils {
             return dim(0);
         }
 
+        // A view of the region at offsets with the given extents in the first N dims, sharing this view's data
+        // and dimstride, so nothing is copied. Dims past N are kept whole.
+        template <size_t N>
+        [[nodiscard]] matrix_view subview(const long (&offsets)[N], const long (&extents)[N]) const {
+            assert(N <= static_cast<size_t>(info.dimcount));
+            matrix_view view{*this};
+            for (size_t i = 0; i < N; ++i) {
+                assert(offsets[i] >= 0 && extents[i] >= 0 && offsets[i] + extents[i] <= info.dim[i]);
+                view.data += offsets[i] * info.dimstride[i];
+                view.info.dim[i] = extents[i];
+            }
+            // bytes from the first cell to the end of the last, which is what at() checks against
+            view.info.size = info.dimstride[0];
+            for (long i = 0; i < info.dimcount; ++i) {
+                if (view.info.dim[i] == 0) {
+                    view.info.size = 0;
+                    break;
+                }
+                view.info.size += (view.info.dim[i] - 1) * info.dimstride[i];
+            }
+            view.sub = true;
+            return view;
+        }
+
+        [[nodiscard]] bool is_subview() const {
+            return sub;
+        }
+
+        // True if the byte ranges of the two views, from each one's first byte to its info.size, intersect.
+        // Kernels that can't work in place use it to reject a dst that is src or shares any of its rows.
+        // Side by side subviews of one matrix interleave their rows, so they count as overlapping too.
+        template <typename U>
+        [[nodiscard]] bool overlaps(const matrix_view<U> &other) const {
+            const auto a = reinterpret_cast<uintptr_t>(data);
+            const auto b = reinterpret_cast<uintptr_t>(other.raw_data());
+            return a < b + static_cast<uintptr_t>(other.matrix_info().size) && b < a + static_cast<uintptr_t>(info.size);
+        }
+
         template <size_t N>
         t_jit_err set_dims(const long (&dims)[N]) {
+            // a subview can't resize the matrix under its parent
+            if (sub) {
+                return JIT_ERR_GENERIC;
+            }
             for (size_t i = 0; i < N; ++i) {
                 info.dim[i] = dims[i];
             }
@@ -207,6 +278,9 @@ namespace maxutils {
         }
 
         t_jit_err set_planecount(long planecount) {
+            if (sub) {
+                return JIT_ERR_GENERIC;
+            }
             info.planecount = planecount;
             auto err = (t_jit_err)jit_object_method(matrix, _jit_sym_setinfo_ex, &info);
             if (err != JIT_ERR_NONE) {
@@ -224,13 +298,30 @@ namespace maxutils {
         }
 
         t_jit_err clear() {
-            return (t_jit_err)jit_object_method(matrix, _jit_sym_clear);
+            if (!sub) {
+                return (t_jit_err)jit_object_method(matrix, _jit_sym_clear);
+            }
+            // only the region: row by row over every dim above the first
+            long rows = 1;
+            for (long i = 1; i < info.dimcount; ++i) {
+                rows *= info.dim[i];
+            }
+            for (long r = 0; r < rows; ++r) {
+                long offset = 0;
+                for (long i = 1, rest = r; i < info.dimcount; ++i) {
+                    offset += rest % info.dim[i] * info.dimstride[i];
+                    rest /= info.dim[i];
+                }
+                std::memset(data + offset, 0, info.dim[0] * info.dimstride[0]);
+            }
+            return JIT_ERR_NONE;
         }
 
     private:
         t_jit_matrix_info info;
         char *data;
         t_object *matrix;
+        bool sub = false;
     };
 
 
@@ -6,10 +6,49 @@
 #define JIT_OPENCV_HPP
 
 #include "jit.common.h"
+#include "jit_matrix_view_v2.hpp"
 #include <algorithm>
 #include "opencv2/core/mat.hpp"
 
 namespace maxutils {
+    namespace detail {
+        // Wraps data laid out as described by info, without copying.
+        inline cv::Mat cv_mat_over(const c74::max::t_jit_matrix_info &info, void *data) {
+            using namespace c74::max;
+
+            const auto type = [](t_symbol *type, long planecount) -> int {
+                if (type == _jit_sym_char) {
+                    return CV_8UC(planecount);
+                }
+                if (type == _jit_sym_long) {
+                    return CV_32SC(planecount);
+                }
+                if (type == _jit_sym_float32) {
+                    return CV_32FC(planecount);
+                }
+                if (type == _jit_sym_float64) {
+                    return CV_64FC(planecount);
+                }
+                return -1;
+            }(info.type, info.planecount);
+
+            int dims = info.dimcount;
+            int sizes[JIT_MATRIX_MAX_DIMCOUNT]{};
+            std::copy_n(info.dim, info.dimcount, sizes);
+            std::swap(sizes[0], sizes[1]);
+            size_t steps[JIT_MATRIX_MAX_DIMCOUNT]{};
+            std::copy_n(info.dimstride, info.dimcount, steps);
+            std::swap(steps[0], steps[1]);
+            return {
+                dims,
+                sizes,
+                type,
+                data,
+                steps
+            };
+        }
+    }
+
     inline cv::Mat jit_matrix_to_cv_mat(void *matrix) {
         using namespace c74::max;
 
@@ -33,22 +72,6 @@ namespace maxutils {
         //     return {};
         // }
 
-        const auto type = [](t_symbol *type, long planecount) -> int {
-            if (type == _jit_sym_char) {
-                return CV_8UC(planecount);
-            }
-            if (type == _jit_sym_long) {
-                return CV_32SC(planecount);
-            }
-            if (type == _jit_sym_float32) {
-                return CV_32FC(planecount);
-            }
-            if (type == _jit_sym_float64) {
-                return CV_64FC(planecount);
-            }
-            return -1;
-        }(info.type, info.planecount);
-
         void *data;
         err = (t_jit_err) jit_object_method(matrix, _jit_sym_getdata, &data);
         if (err) {
@@ -57,20 +80,13 @@ namespace maxutils {
             return {};
         }
 
-        int dims = info.dimcount;
-        int sizes[JIT_MATRIX_MAX_DIMCOUNT]{};
-        std::copy_n(info.dim, info.dimcount, sizes);
-        std::swap(sizes[0], sizes[1]);
-        size_t steps[JIT_MATRIX_MAX_DIMCOUNT]{};
-        std::copy_n(info.dimstride, info.dimcount, steps);
-        std::swap(steps[0], steps[1]);
-        return {
-            dims,
-            sizes,
-            type,
-            data,
-            steps
-        };
+        return detail::cv_mat_over(info, data);
+    }
+
+    // The same over a matrix_view, so a subview becomes a cv::Mat of just that region.
+    template <typename T>
+    cv::Mat to_cv_mat(matrix_view<T> &view) {
+        return detail::cv_mat_over(view.matrix_info(), const_cast<char *>(view.raw_data()));
     }
 }
 #endif //JIT_OPENCV_HPP
@@ -0,0 +1,429 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef LUT_HPP
+#define LUT_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "c74_jitter.h"
+#include "jit_matrix_view_v2.hpp"
+#include "tracer.hpp"
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+
+namespace maxutils {
+    using namespace c74::max;
+
+    // A tone curve through control points in [0, 1], interpolated with a monotone cubic (Fritsch-Carlson) so
+    // it never overshoots between points. Flat before the first and after the last point.
+    class tone_curve {
+    public:
+        struct point {
+            float x;
+            float y;
+        };
+
+        tone_curve() : tone_curve({{0.0f, 0.0f}, {1.0f, 1.0f}}) {
+        }
+
+        tone_curve(std::vector<point> points) : points{std::move(points)} {
+            if (this->points.empty()) {
+                throw std::runtime_error("Tone curve needs at least one point");
+            }
+            std::sort(this->points.begin(), this->points.end(), [](point a, point b) { return a.x < b.x; });
+            update_tangents(0, this->points.size());
+        }
+
+        [[nodiscard]] const std::vector<point> &control_points() const {
+            return points;
+        }
+
+        // Moves point i, keeping it between its neighbours. Returns the range of 8-bit table entries
+        // [first, last) whose value may have changed.
+        std::pair<int, int> move_point(size_t i, float x, float y) {
+            const float lo = i > 0 ? points[i - 1].x : 0.0f;
+            const float hi = i + 1 < points.size() ? points[i + 1].x : 1.0f;
+            points[i] = {std::clamp(x, lo, hi), y};
+            // a point's move changes the secants either side of it, so the tangents of it and its
+            // neighbours, so the two segments either side of those
+            const size_t first = i >= 2 ? i - 2 : 0;
+            const size_t last = std::min(i + 2, points.size() - 1);
+            update_tangents(i > 0 ? i - 1 : 0, std::min(i + 2, points.size()));
+            return {
+                first == 0 ? 0 : static_cast<int>(std::floor(points[first].x * 255.0f)),
+                last == points.size() - 1 ? 256 : static_cast<int>(std::ceil(points[last].x * 255.0f)) + 1
+            };
+        }
+
+        [[nodiscard]] float operator()(float x) const {
+            if (x <= points.front().x) {
+                return points.front().y;
+            }
+            if (x >= points.back().x) {
+                return points.back().y;
+            }
+            const auto it = std::upper_bound(points.begin(), points.end(), x,
+                                             [](float v, point p) { return v < p.x; });
+            const size_t k = it - points.begin() - 1;
+            const float h = points[k + 1].x - points[k].x;
+            if (h <= 0.0f) {
+                return points[k + 1].y;
+            }
+            const float t = (x - points[k].x) / h;
+            const float t2 = t * t, t3 = t2 * t;
+            return (2 * t3 - 3 * t2 + 1) * points[k].y + (t3 - 2 * t2 + t) * h * tangents[k]
+                   + (-2 * t3 + 3 * t2) * points[k + 1].y + (t3 - t2) * h * tangents[k + 1];
+        }
+
+    private:
+        [[nodiscard]] float secant(size_t k) const {
+            const float h = points[k + 1].x - points[k].x;
+            return h > 0.0f ? (points[k + 1].y - points[k].y) / h : 0.0f;
+        }
+
+        void update_tangents(size_t first, size_t last) {
+            const size_t n = points.size();
+            tangents.resize(n);
+            for (size_t k = first; k < last; ++k) {
+                if (n == 1) {
+                    tangents[k] = 0.0f;
+                } else if (k == 0) {
+                    tangents[k] = secant(0);
+                } else if (k == n - 1) {
+                    tangents[k] = secant(n - 2);
+                } else {
+                    const float a = secant(k - 1), b = secant(k);
+                    // harmonic mean of the secants, zero at extrema, keeps each segment monotone
+                    tangents[k] = a * b > 0.0f ? 2.0f * a * b / (a + b) : 0.0f;
+                }
+            }
+        }
+
+        std::vector<point> points;
+        std::vector<float> tangents;
+    };
+
+    // 256-entry lookup tables for char matrices, one per plane. A single table applies to every plane.
+    class plane_lut {
+    public:
+        using table = std::array<uint8_t, 256>;
+
+        explicit plane_lut(long planecount = 4) : tables(planecount), curves(planecount) {
+            if (planecount < 1) {
+                throw std::runtime_error("Invalid planecount");
+            }
+            for (long p = 0; p < planecount; ++p) {
+                fill(p, [](float x) { return x; });
+            }
+        }
+
+        [[nodiscard]] long planecount() const {
+            return static_cast<long>(tables.size());
+        }
+
+        [[nodiscard]] const table &get_table(long plane) const {
+            return tables[plane];
+        }
+
+        void set_entry(long plane, uint8_t index, uint8_t value) {
+            tables[plane][index] = value;
+        }
+
+        // fn maps [0, 1] to [0, 1]
+        template <typename F>
+        void fill(long plane, F &&fn, int first = 0, int last = 256) {
+            for (int i = first; i < last; ++i) {
+                const float y = fn(static_cast<float>(i) / 255.0f);
+                tables[plane][i] = static_cast<uint8_t>(std::clamp(y, 0.0f, 1.0f) * 255.0f + 0.5f);
+            }
+        }
+
+        void set_gamma(long plane, float gamma) {
+            fill(plane, [gamma](float x) { return std::pow(x, 1.0f / gamma); });
+        }
+
+        void set_curve(long plane, tone_curve curve) {
+            curves[plane] = std::move(curve);
+            fill(plane, curves[plane]);
+        }
+
+        // Moves a control point of the plane's curve, only recomputing the entries it affects.
+        void move_point(long plane, size_t i, float x, float y) {
+            const auto [first, last] = curves[plane].move_point(i, x, y);
+            fill(plane, curves[plane], std::max(first, 0), std::min(last, 256));
+        }
+
+        [[nodiscard]] const tone_curve &curve(long plane) const {
+            return curves[plane];
+        }
+
+    private:
+        std::vector<table> tables;
+        std::vector<tone_curve> curves;
+    };
+
+    namespace detail {
+#if MAXUTILS_SIMD_NEON && defined(__aarch64__)
+        // Full 256-byte table lookup: TBL covers the first 64 entries (zero beyond), TBX each further quarter,
+        // with the index xor'd into range so it only hits for lanes in that quarter.
+        inline uint8x16_t lookup16(uint8x16_t idx, const uint8x16x4_t &t0, const uint8x16x4_t &t1,
+                                   const uint8x16x4_t &t2, const uint8x16x4_t &t3) {
+            uint8x16_t r = vqtbl4q_u8(t0, idx);
+            r = vqtbx4q_u8(r, t1, veorq_u8(idx, vdupq_n_u8(0x40)));
+            r = vqtbx4q_u8(r, t2, veorq_u8(idx, vdupq_n_u8(0x80)));
+            return vqtbx4q_u8(r, t3, veorq_u8(idx, vdupq_n_u8(0xc0)));
+        }
+#endif
+
+        inline void lut_flat(const uint8_t *in, uint8_t *out, long n, const uint8_t *t) {
+            long i = 0;
+#if MAXUTILS_SIMD_NEON && defined(__aarch64__)
+            const uint8x16x4_t t0 = vld1q_u8_x4(t), t1 = vld1q_u8_x4(t + 64);
+            const uint8x16x4_t t2 = vld1q_u8_x4(t + 128), t3 = vld1q_u8_x4(t + 192);
+            for (; i + 16 <= n; i += 16) {
+                vst1q_u8(out + i, lookup16(vld1q_u8(in + i), t0, t1, t2, t3));
+            }
+#endif
+            for (; i + 4 <= n; i += 4) {
+                out[i] = t[in[i]];
+                out[i + 1] = t[in[i + 1]];
+                out[i + 2] = t[in[i + 2]];
+                out[i + 3] = t[in[i + 3]];
+            }
+            for (; i < n; ++i) {
+                out[i] = t[in[i]];
+            }
+        }
+
+
+        inline void lut_argb(const uint8_t *in, uint8_t *out, long cells, const plane_lut &lut) {
+            const uint8_t *t0 = lut.get_table(0).data(), *t1 = lut.get_table(1).data();
+            const uint8_t *t2 = lut.get_table(2).data(), *t3 = lut.get_table(3).data();
+            long c = 0;
+#if MAXUTILS_SIMD_NEON && defined(__aarch64__)
+            // 16 cells at a time; the tables don't all fit in registers so each plane reloads its own
+            for (; c + 16 <= cells; c += 16) {
+                uint8x16x4_t v = vld4q_u8(in + c * 4);
+                const uint8_t *tables[4] = {t0, t1, t2, t3};
+                for (int p = 0; p < 4; ++p) {
+                    const uint8_t *t = tables[p];
+                    v.val[p] = lookup16(v.val[p], vld1q_u8_x4(t), vld1q_u8_x4(t + 64), vld1q_u8_x4(t + 128),
+                                        vld1q_u8_x4(t + 192));
+                }
+                vst4q_u8(out + c * 4, v);
+            }
+#endif
+            for (; c < cells; ++c) {
+                out[c * 4] = t0[in[c * 4]];
+                out[c * 4 + 1] = t1[in[c * 4 + 1]];
+                out[c * 4 + 2] = t2[in[c * 4 + 2]];
+                out[c * 4 + 3] = t3[in[c * 4 + 3]];
+            }
+        }
+
+        inline void lut_planes(const uint8_t *in, uint8_t *out, long cells, long planes, const plane_lut &lut) {
+            for (long p = 0; p < planes; ++p) {
+                const uint8_t *t = lut.get_table(p).data();
+                for (long c = 0; c < cells; ++c) {
+                    out[c * planes + p] = t[in[c * planes + p]];
+                }
+            }
+        }
+    }
+
+    // Applies lut to a char matrix. src and dst may be the same matrix.
+    inline t_jit_err apply_lut(matrix_view<char> src, matrix_view<char> dst, const plane_lut &lut) {
+        const long planes = static_cast<long>(src.planecount());
+        if (dst.planecount() != src.planecount() || (lut.planecount() != 1 && lut.planecount() != planes)) {
+            return JIT_ERR_MISMATCH_PLANE;
+        }
+        if (src.dimcount() != dst.dimcount() || src.dimcount() > 2 || src.ncols() != dst.ncols()
+            || (src.dimcount() == 2 && src.nrows() != dst.nrows())) {
+            return JIT_ERR_MISMATCH_DIM;
+        }
+        trace_scope span{"apply_lut", "lut"};
+        const long cols = src.ncols();
+        const long rows = src.dimcount() > 1 ? src.nrows() : 1;
+        const bool shared = lut.planecount() == 1;
+        detail::parallel_for(0, rows, std::max(1l, (1l << 16) / std::max(1l, cols * planes)),
+                             [&](size_t begin, size_t end) {
+                                 for (size_t y = begin; y < end; ++y) {
+                                     auto in = reinterpret_cast<const uint8_t *>(src.row(y).as_1d_span().data());
+                                     auto out = reinterpret_cast<uint8_t *>(dst.row(y).as_1d_span().data());
+                                     if (shared) {
+                                         detail::lut_flat(in, out, cols * planes, lut.get_table(0).data());
+                                     } else if (planes == 4) {
+                                         detail::lut_argb(in, out, cols, lut);
+                                     } else if (planes == 1) {
+                                         detail::lut_flat(in, out, cols, lut.get_table(0).data());
+                                     } else {
+                                         detail::lut_planes(in, out, cols, planes, lut);
+                                     }
+                                 }
+                             });
+        return JIT_ERR_NONE;
+    }
+
+    enum class lut_interp {
+        trilinear,
+        tetrahedral,
+    };
+
+    // A size^3 RGB colour cube over [0, 1]^3 (e.g. a loaded .cube file). Entries are padded to four floats so
+    // each corner is a single f32x4 load.
+    class color_lut {
+    public:
+        using rgb = std::array<float, 3>;
+
+        explicit color_lut(long size = 33) : n{size}, entries(size * size * size * 4) {
+            if (size < 2) {
+                throw std::runtime_error("Colour LUT size must be at least 2");
+            }
+            set_all([](rgb c) { return c; });
+        }
+
+        // fn maps an input rgb in [0, 1]^3 to its output
+        template <typename F>
+        static color_lut from_function(long size, F &&fn) {
+            color_lut lut{size};
+            lut.set_all(std::forward<F>(fn));
+            return lut;
+        }
+
+        [[nodiscard]] long size() const {
+            return n;
+        }
+
+        [[nodiscard]] rgb at(long r, long g, long b) const {
+            const float *e = entry(r, g, b);
+            return {e[0], e[1], e[2]};
+        }
+
+        void set(long r, long g, long b, rgb value) {
+            float *e = entries.data() + index(r, g, b);
+            e[0] = value[0];
+            e[1] = value[1];
+            e[2] = value[2];
+        }
+
+        template <typename F>
+        void set_all(F &&fn) {
+            const float scale = 1.0f / static_cast<float>(n - 1);
+            for (long b = 0; b < n; ++b) {
+                for (long g = 0; g < n; ++g) {
+                    for (long r = 0; r < n; ++r) {
+                        set(r, g, b, fn(rgb{r * scale, g * scale, b * scale}));
+                    }
+                }
+            }
+        }
+
+        // Writes the looked-up colour to out[0..2]. out needs room for four floats.
+        void sample(float r, float g, float b, lut_interp interp, float *out) const {
+            using detail::f32x4;
+            long i[3];
+            float f[3];
+            const float in[3] = {r, g, b};
+            for (int k = 0; k < 3; ++k) {
+                const float x = std::clamp(in[k], 0.0f, 1.0f) * static_cast<float>(n - 1);
+                i[k] = std::min(static_cast<long>(x), n - 2);
+                f[k] = x - static_cast<float>(i[k]);
+            }
+            auto corner = [&](int dr, int dg, int db) {
+                return f32x4::load(entry(i[0] + dr, i[1] + dg, i[2] + db));
+            };
+            const auto c000 = corner(0, 0, 0), c111 = corner(1, 1, 1);
+            f32x4 result;
+            if (interp == lut_interp::trilinear) {
+                const auto fr = f32x4::set1(f[0]), fg = f32x4::set1(f[1]), fb = f32x4::set1(f[2]);
+                const auto c100 = corner(1, 0, 0), c010 = corner(0, 1, 0), c110 = corner(1, 1, 0);
+                const auto c001 = corner(0, 0, 1), c101 = corner(1, 0, 1), c011 = corner(0, 1, 1);
+                const auto c00 = fma(c000, fr, c100 - c000), c10 = fma(c010, fr, c110 - c010);
+                const auto c01 = fma(c001, fr, c101 - c001), c11 = fma(c011, fr, c111 - c011);
+                const auto c0 = fma(c00, fg, c10 - c00), c1 = fma(c01, fg, c11 - c01);
+                result = fma(c0, fb, c1 - c0);
+            } else {
+                // walk the diagonal of the cell through the tetrahedron picked by the order of the fractions
+                const float fr = f[0], fg = f[1], fb = f[2];
+                f32x4 a, b;
+                float wa, wb, wc;
+                if (fr > fg) {
+                    if (fg > fb) {
+                        a = corner(1, 0, 0), b = corner(1, 1, 0), wa = fr, wb = fg, wc = fb;
+                    } else if (fr > fb) {
+                        a = corner(1, 0, 0), b = corner(1, 0, 1), wa = fr, wb = fb, wc = fg;
+                    } else {
+                        a = corner(0, 0, 1), b = corner(1, 0, 1), wa = fb, wb = fr, wc = fg;
+                    }
+                } else {
+                    if (fb > fg) {
+                        a = corner(0, 0, 1), b = corner(0, 1, 1), wa = fb, wb = fg, wc = fr;
+                    } else if (fb > fr) {
+                        a = corner(0, 1, 0), b = corner(0, 1, 1), wa = fg, wb = fb, wc = fr;
+                    } else {
+                        a = corner(0, 1, 0), b = corner(1, 1, 0), wa = fg, wb = fr, wc = fb;
+                    }
+                }
+                result = fma(fma(fma(c000, f32x4::set1(wa), a - c000), f32x4::set1(wb), b - a),
+                             f32x4::set1(wc), c111 - b);
+            }
+            result.store(out);
+        }
+
+    private:
+        [[nodiscard]] size_t index(long r, long g, long b) const {
+            return static_cast<size_t>(((b * n + g) * n + r) * 4);
+        }
+
+        [[nodiscard]] const float *entry(long r, long g, long b) const {
+            return entries.data() + index(r, g, b);
+        }
+
+        long n;
+        std::vector<float> entries;
+    };
+
+    // Applies a colour cube to a float32 matrix: planes 0-2 for 3-plane RGB, 1-3 for ARGB with alpha passed
+    // through. src and dst may be the same matrix.
+    inline t_jit_err apply_lut(matrix_view<float> src, matrix_view<float> dst, const color_lut &lut,
+                               lut_interp interp = lut_interp::tetrahedral) {
+        const long planes = static_cast<long>(src.planecount());
+        if (dst.planecount() != src.planecount() || (planes != 3 && planes != 4)) {
+            return JIT_ERR_MISMATCH_PLANE;
+        }
+        if (src.dimcount() != dst.dimcount() || src.dimcount() > 2 || src.ncols() != dst.ncols()
+            || (src.dimcount() == 2 && src.nrows() != dst.nrows())) {
+            return JIT_ERR_MISMATCH_DIM;
+        }
+        trace_scope span{"apply_lut", "lut"};
+        const long cols = src.ncols();
+        const long rows = src.dimcount() > 1 ? src.nrows() : 1;
+        const long first = planes == 4 ? 1 : 0;
+        detail::parallel_for(0, rows, std::max(1l, (1l << 13) / std::max(1l, cols)), [&](size_t begin, size_t end) {
+            for (size_t y = begin; y < end; ++y) {
+                const float *in = src.row(y).as_1d_span().data();
+                float *out = dst.row(y).as_1d_span().data();
+                float rgb[4];
+                for (long x = 0; x < cols; ++x) {
+                    const float *c = in + x * planes + first;
+                    lut.sample(c[0], c[1], c[2], interp, rgb);
+                    if (first) {
+                        out[x * planes] = in[x * planes];
+                    }
+                    std::copy_n(rgb, 3, out + x * planes + first);
+                }
+            }
+        });
+        return JIT_ERR_NONE;
+    }
+}
+
+#endif //LUT_HPP
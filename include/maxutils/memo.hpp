@@ -0,0 +1,180 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef MEMO_HPP
+#define MEMO_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "c74_jitter.h"
+#include "jit_matrix_helpers.hpp"
+#include "jit_matrix_view_v2.hpp"
+#include "named_matrix.hpp"
+#include "tracer.hpp"
+#include "detail/content_hash.hpp"
+
+namespace maxutils {
+    using namespace c74::max;
+
+    namespace detail {
+        // Hashes type, planecount and dims, then the data one dim[0] run at a time so row padding is skipped.
+        inline uint64_t matrix_content_hash(const t_jit_matrix_info &info, const char *data) {
+            trace_scope span{"content hash", "matrix"};
+            content_hash hash;
+            hash.update_value(info.type);
+            hash.update_value(info.planecount);
+            hash.update_value(info.dimcount);
+            hash.update(info.dim, sizeof(long) * info.dimcount);
+            if (!data || info.dimcount < 1) {
+                return hash.digest();
+            }
+            const size_t run_bytes = info.dim[0] * info.dimstride[0];
+            long index[JIT_MATRIX_MAX_DIMCOUNT] = {};
+            for (;;) {
+                long offset = 0;
+                for (long d = 1; d < info.dimcount; ++d) {
+                    offset += index[d] * info.dimstride[d];
+                }
+                hash.update(data + offset, run_bytes);
+                long d = 1;
+                for (; d < info.dimcount; ++d) {
+                    if (++index[d] < info.dim[d]) {
+                        break;
+                    }
+                    index[d] = 0;
+                }
+                if (d >= info.dimcount) {
+                    return hash.digest();
+                }
+            }
+        }
+    }
+
+    // Content hash of a locked matrix. Equal matrices hash equal; different ones almost certainly don't.
+    inline uint64_t matrix_hash(t_object *matrix) {
+        t_jit_matrix_info info;
+        char *data = nullptr;
+        jit_object_method(matrix, _jit_sym_getinfo, &info);
+        jit_object_method(matrix, _jit_sym_getdata, &data);
+        return detail::matrix_content_hash(info, data);
+    }
+
+    template <typename T>
+    uint64_t matrix_hash(const matrix_view<T> &view) {
+        return detail::matrix_content_hash(view.matrix_info(), view.raw_data());
+    }
+
+    // Combines input hashes and an attribute snapshot (attr_schema<Object>::get().snapshot(x)) into a memo key.
+    inline uint64_t memo_key(std::initializer_list<uint64_t> input_hashes, std::span<const std::byte> attrs = {}) {
+        uint64_t key = detail::content_hash::of(attrs.data(), attrs.size());
+        for (auto h: input_hashes) {
+            key = detail::hash_combine(key, h);
+        }
+        return key;
+    }
+
+    // Small least-recently-used cache of result matrices keyed by memo_key, so an object whose inputs and
+    // attributes haven't changed can output a stored result instead of recomputing it. Evicted entries keep
+    // their matrix and are refilled in place. Meant to be used from a single thread.
+    class matrix_memo {
+    public:
+        explicit matrix_memo(size_t capacity = 4) : entries(capacity < 1 ? 1 : capacity) {
+        }
+
+        matrix_memo(const matrix_memo &) = delete;
+        matrix_memo &operator=(const matrix_memo &) = delete;
+
+        // The cached result for key, or nullptr.
+        NamedMatrix *find(uint64_t key) {
+            for (auto &e: entries) {
+                if (e.valid && e.key == key) {
+                    e.last_used = ++clock;
+                    ++hit_count;
+                    return e.result.get();
+                }
+            }
+            ++miss_count;
+            return nullptr;
+        }
+
+        // Copies result (locked by the caller) into the cache under key.
+        NamedMatrix *store(uint64_t key, t_object *result) {
+            entry *slot = nullptr;
+            for (auto &e: entries) {
+                if (e.valid && e.key == key) {
+                    slot = &e;
+                    break;
+                }
+            }
+            if (!slot) {
+                // least recently used, with empty entries counting as never used
+                slot = &*std::min_element(entries.begin(), entries.end(), [](const entry &a, const entry &b) {
+                    return (a.valid ? a.last_used : 0) < (b.valid ? b.last_used : 0);
+                });
+            }
+            if (!slot->result) {
+                t_jit_matrix_info info;
+                jit_object_method(result, _jit_sym_getinfo, &info);
+                slot->result = std::make_unique<NamedMatrix>(&info);
+            }
+            {
+                trace_scope span{"memo store", "matrix"};
+                jit_matrix_copy_adapt((t_object *) slot->result->matrix, result);
+            }
+            slot->key = key;
+            slot->valid = true;
+            slot->last_used = ++clock;
+            return slot->result.get();
+        }
+
+        // Drop-in for a matrix_calc body: outputs the cached result for key into out_matrix if there is one,
+        // otherwise runs compute(out_matrix) and caches what it produced. Both matrices must be locked.
+        template <typename Compute>
+        t_jit_err calc(uint64_t key, t_object *out_matrix, Compute &&compute) {
+            if (auto cached = find(key)) {
+                trace_scope span{"memo hit", "matrix"};
+                return jit_matrix_copy_adapt(out_matrix, (t_object *) cached->matrix);
+            }
+            const t_jit_err err = compute(out_matrix);
+            if (err == JIT_ERR_NONE) {
+                store(key, out_matrix);
+            }
+            return err;
+        }
+
+        void clear() {
+            for (auto &e: entries) {
+                e.valid = false;
+            }
+        }
+
+        [[nodiscard]] size_t hits() const {
+            return hit_count;
+        }
+
+        [[nodiscard]] size_t misses() const {
+            return miss_count;
+        }
+
+    private:
+        struct entry {
+            uint64_t key = 0;
+            uint64_t last_used = 0;
+            bool valid = false;
+            std::unique_ptr<NamedMatrix> result;
+        };
+
+        std::vector<entry> entries;
+        uint64_t clock = 0;
+        size_t hit_count = 0;
+        size_t miss_count = 0;
+    };
+}
+
+#endif //MEMO_HPP
@@ -6,6 +6,7 @@
 #define NAMED_MATRIX_HPP
 
 #include "ext.h"
+#include "tracer.hpp"
 
 using namespace c74::max;
 
@@ -90,6 +91,7 @@ public:
 
     void *data() {
         if (!matrix) return nullptr;
+        maxutils::trace_scope span{"getdata", "matrix"};
         void *data;
         auto err = (t_jit_err) jit_object_method(matrix, gensym("getdata"), &data);
         if (err) {
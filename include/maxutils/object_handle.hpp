@@ -7,8 +7,10 @@
 
 #include <memory>
 #include "ext.h"
+#include "c74_jitter.h"
 
 namespace maxutils {
+    using namespace c74::max;
 
     template <typename T>
     concept PtrIntComaptible = sizeof(T) == sizeof(t_ptr_int);
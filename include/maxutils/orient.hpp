@@ -0,0 +1,246 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef ORIENT_HPP
+#define ORIENT_HPP
+
+#include <algorithm>
+#include <cstring>
+
+#include "c74_jitter.h"
+#include "jit_matrix_view_v2.hpp"
+#include "tracer.hpp"
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+
+namespace maxutils {
+    using namespace c74::max;
+
+    // The eight ways to lay a rectangle back on itself. Rotations are clockwise as displayed (row 0 at the
+    // top); transpose swaps x and y, transverse swaps them across the other diagonal.
+    enum class orientation {
+        identity,
+        rotate90,
+        rotate180,
+        rotate270,
+        flip_x,
+        flip_y,
+        transpose,
+        transverse,
+    };
+
+    namespace detail {
+        // For unswapped orientations dst(x, y) = src(rev_x ? w-1-x : x, rev_y ? h-1-y : y); swapped ones index
+        // src with the dst coordinates exchanged first: dst(x, y) = src(rev_x ? w-1-y : y, rev_y ? h-1-x : x).
+        struct orient_map {
+            bool swap;
+            bool rev_x;
+            bool rev_y;
+        };
+
+        constexpr orient_map map_of(orientation o) {
+            switch (o) {
+                case orientation::rotate90:
+                    return {true, false, true};
+                case orientation::rotate180:
+                    return {false, true, true};
+                case orientation::rotate270:
+                    return {true, true, false};
+                case orientation::flip_x:
+                    return {false, true, false};
+                case orientation::flip_y:
+                    return {false, false, true};
+                case orientation::transpose:
+                    return {true, false, false};
+                case orientation::transverse:
+                    return {true, true, true};
+                default:
+                    return {false, false, false};
+            }
+        }
+
+        // Raw layout of a 2D view, in bytes.
+        struct orient_plane {
+            unsigned char *data;
+            long row_stride;
+            long width;
+            long height;
+        };
+
+        // Cells are `bytes` long; B is the same as a constant, or 0 when it's only known at runtime.
+        template <size_t B>
+        void copy_cell(unsigned char *dst, const unsigned char *src, size_t bytes) {
+            if constexpr (B == 0) {
+                std::memcpy(dst, src, bytes);
+            } else {
+                std::memcpy(dst, src, B);
+            }
+        }
+
+        template <size_t B>
+        void orient_rows(const orient_plane &src, const orient_plane &dst, orient_map map, size_t bytes) {
+            const long w = dst.width;
+            parallel_for(0, dst.height, std::max(1l, (1l << 16) / std::max(1l, w * static_cast<long>(bytes))),
+                         [&](size_t begin, size_t end) {
+                             for (long y = static_cast<long>(begin); y < static_cast<long>(end); ++y) {
+                                 const unsigned char *in = src.data + (map.rev_y ? src.height - 1 - y : y) * src.row_stride;
+                                 unsigned char *out = dst.data + y * dst.row_stride;
+                                 if (!map.rev_x) {
+                                     std::memcpy(out, in, w * bytes);
+                                     continue;
+                                 }
+                                 long x = 0;
+                                 if constexpr (B == 4) {
+                                     for (; x + 4 <= w; x += 4) {
+                                         reverse(f32x4::load(reinterpret_cast<const float *>(in + (w - 4 - x) * 4)))
+                                                 .store(reinterpret_cast<float *>(out + x * 4));
+                                     }
+                                 }
+                                 for (; x < w; ++x) {
+                                     copy_cell<B>(out + x * bytes, in + (w - 1 - x) * bytes, bytes);
+                                 }
+                             }
+                         });
+        }
+
+        // One dst tile [x0, x1) x [y0, y1) of a swapped orientation.
+        template <size_t B>
+        void orient_tile(const orient_plane &src, const orient_plane &dst, orient_map map, size_t bytes,
+                         long x0, long x1, long y0, long y1) {
+            auto src_x = [&](long y) { return map.rev_x ? src.width - 1 - y : y; };
+            auto src_y = [&](long x) { return map.rev_y ? src.height - 1 - x : x; };
+            long y = y0;
+            if constexpr (B == 4) {
+                // 4x4 cells at a time: four src rows (dst columns) loaded, transposed in registers, stored as four
+                // dst rows
+                for (; y + 4 <= y1; y += 4) {
+                    const long sx = map.rev_x ? src.width - 1 - (y + 3) : y;
+                    long x = x0;
+                    for (; x + 4 <= x1; x += 4) {
+                        f32x4 r[4];
+                        for (int k = 0; k < 4; ++k) {
+                            r[k] = f32x4::load(reinterpret_cast<const float *>(
+                                src.data + src_y(x + k) * src.row_stride + sx * 4));
+                            if (map.rev_x) {
+                                r[k] = reverse(r[k]);
+                            }
+                        }
+                        transpose4(r[0], r[1], r[2], r[3]);
+                        for (int k = 0; k < 4; ++k) {
+                            r[k].store(reinterpret_cast<float *>(dst.data + (y + k) * dst.row_stride + x * 4));
+                        }
+                    }
+                    for (long yy = y; yy < y + 4; ++yy) {
+                        for (long xx = x; xx < x1; ++xx) {
+                            copy_cell<B>(dst.data + yy * dst.row_stride + xx * 4,
+                                         src.data + src_y(xx) * src.row_stride + src_x(yy) * 4, 4);
+                        }
+                    }
+                }
+            }
+            for (; y < y1; ++y) {
+                unsigned char *out = dst.data + y * dst.row_stride;
+                const unsigned char *in = src.data + src_x(y) * bytes;
+                for (long x = x0; x < x1; ++x) {
+                    copy_cell<B>(out + x * bytes, in + src_y(x) * src.row_stride, bytes);
+                }
+            }
+        }
+
+        template <size_t B>
+        void orient_tiles(const orient_plane &src, const orient_plane &dst, orient_map map, size_t bytes) {
+            // a tile of each side fits in L1 for cells up to 16 bytes
+            constexpr long tile = 32;
+            const long tiles_y = (dst.height + tile - 1) / tile;
+            parallel_for(0, tiles_y, 1, [&](size_t begin, size_t end) {
+                for (long ty = static_cast<long>(begin); ty < static_cast<long>(end); ++ty) {
+                    const long y0 = ty * tile, y1 = std::min(y0 + tile, dst.height);
+                    for (long x0 = 0; x0 < dst.width; x0 += tile) {
+                        orient_tile<B>(src, dst, map, bytes, x0, std::min(x0 + tile, dst.width), y0, y1);
+                    }
+                }
+            });
+        }
+
+        template <size_t B>
+        void orient(const orient_plane &src, const orient_plane &dst, orient_map map, size_t bytes) {
+            if (map.swap) {
+                orient_tiles<B>(src, dst, map, bytes);
+            } else {
+                orient_rows<B>(src, dst, map, bytes);
+            }
+        }
+
+        template <typename T>
+        orient_plane plane_of(matrix_view<T> &view) {
+            const auto &info = view.matrix_info();
+            return {
+                reinterpret_cast<unsigned char *>(const_cast<char *>(view.raw_data())),
+                info.dimcount > 1 ? info.dimstride[1] : 0,
+                view.ncols(),
+                info.dimcount > 1 ? view.nrows() : 1
+            };
+        }
+    }
+
+    // Writes src reoriented into dst, which must already have the resulting dims (swapped for rotate90/270,
+    // transpose and transverse) and src's planecount. Works on any planecount and on subviews; src and dst
+    // must not overlap.
+    template <typename T>
+    t_jit_err reorient(matrix_view<T> &src, matrix_view<T> &dst, orientation o) {
+        const auto map = detail::map_of(o);
+        if (src.planecount() != dst.planecount()) {
+            return JIT_ERR_MISMATCH_PLANE;
+        }
+        if (src.dimcount() > 2 || dst.dimcount() > 2) {
+            return JIT_ERR_MISMATCH_DIM;
+        }
+        const auto s = detail::plane_of(src), d = detail::plane_of(dst);
+        if (map.swap ? (d.width != s.height || d.height != s.width) : (d.width != s.width || d.height != s.height)) {
+            return JIT_ERR_MISMATCH_DIM;
+        }
+        if (src.overlaps(dst)) {
+            return JIT_ERR_INVALID_OUTPUT;
+        }
+        trace_scope span{"reorient", "matrix"};
+        const size_t bytes = sizeof(T) * src.planecount();
+        switch (bytes) {
+            case 1: detail::orient<1>(s, d, map, bytes); break;
+            case 2: detail::orient<2>(s, d, map, bytes); break;
+            case 3: detail::orient<3>(s, d, map, bytes); break;
+            case 4: detail::orient<4>(s, d, map, bytes); break;
+            case 8: detail::orient<8>(s, d, map, bytes); break;
+            case 12: detail::orient<12>(s, d, map, bytes); break;
+            case 16: detail::orient<16>(s, d, map, bytes); break;
+            case 32: detail::orient<32>(s, d, map, bytes); break;
+            default: detail::orient<0>(s, d, map, bytes); break;
+        }
+        return JIT_ERR_NONE;
+    }
+
+    template <typename T>
+    t_jit_err transpose(matrix_view<T> &src, matrix_view<T> &dst) {
+        return reorient(src, dst, orientation::transpose);
+    }
+
+    // Clockwise by a multiple of 90 degrees.
+    template <typename T>
+    t_jit_err rotate(matrix_view<T> &src, matrix_view<T> &dst, int degrees) {
+        switch ((degrees % 360 + 360) % 360) {
+            case 0: return reorient(src, dst, orientation::identity);
+            case 90: return reorient(src, dst, orientation::rotate90);
+            case 180: return reorient(src, dst, orientation::rotate180);
+            case 270: return reorient(src, dst, orientation::rotate270);
+            default: return JIT_ERR_INVALID_INPUT;
+        }
+    }
+
+    template <typename T>
+    t_jit_err flip(matrix_view<T> &src, matrix_view<T> &dst, bool x, bool y) {
+        return reorient(src, dst, x ? (y ? orientation::rotate180 : orientation::flip_x)
+                                    : (y ? orientation::flip_y : orientation::identity));
+    }
+}
+
+#endif //ORIENT_HPP
@@ -0,0 +1,201 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef OUTLET_QUEUE_HPP
+#define OUTLET_QUEUE_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "ext.h"
+#include "object_handle.hpp"
+#include "detail/mpsc_queue.hpp"
+
+namespace maxutils {
+    using namespace c74::max;
+
+    enum class outlet_coalesce {
+        none,   // output every queued message, in order
+        latest, // only output the most recent message of each kind (and selector) queued since the last drain
+    };
+
+    // An outlet that any thread can write to. Messages go into a preallocated lock-free queue and are
+    // output together from a single qelem callback on the main thread, instead of one defer_low per message.
+    // Lists longer than MaxAtoms are rejected, as are pushes onto a full queue; both are counted in dropped().
+    template <size_t MaxAtoms = 16>
+    class outlet_queue {
+    public:
+        outlet_queue(t_object *owner, const char *type = nullptr, size_t capacity = 256,
+                     outlet_coalesce coalesce = outlet_coalesce::none)
+            : outlet{owner, type}, queue{capacity}, coalesce{coalesce},
+              qelem{qelem_new(this, (method) &outlet_queue::drain)} {
+        }
+
+        ~outlet_queue() {
+            qelem_free(qelem);
+        }
+
+        outlet_queue(const outlet_queue &) = delete;
+        outlet_queue &operator=(const outlet_queue &) = delete;
+
+        bool push_bang() {
+            return push(kind::bang, nullptr, [](t_atom *) { return short{0}; });
+        }
+
+        // Any integer (or bool) is output as an int, any floating point value as a float.
+        template <std::integral I>
+        bool push(I value) {
+            return push(kind::int_, nullptr, [value](t_atom *argv) {
+                atom_setlong(argv, static_cast<t_atom_long>(value));
+                return short{1};
+            });
+        }
+
+        template <std::floating_point F>
+        bool push(F value) {
+            return push(kind::float_, nullptr, [value](t_atom *argv) {
+                atom_setfloat(argv, static_cast<double>(value));
+                return short{1};
+            });
+        }
+
+        bool push_list(std::span<const t_atom> atoms) {
+            if (atoms.size() > MaxAtoms) {
+                dropped_count.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            return push(kind::list, nullptr, [atoms](t_atom *argv) {
+                std::copy(atoms.begin(), atoms.end(), argv);
+                return static_cast<short>(atoms.size());
+            });
+        }
+
+        template <typename T>
+        requires std::is_arithmetic_v<T>
+        bool push_list(std::span<const T> values) {
+            if (values.size() > MaxAtoms) {
+                dropped_count.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            return push(kind::list, nullptr, [values](t_atom *argv) {
+                for (size_t i = 0; i < values.size(); ++i) {
+                    if constexpr (std::is_floating_point_v<T>) {
+                        atom_setfloat(argv + i, values[i]);
+                    } else {
+                        atom_setlong(argv + i, values[i]);
+                    }
+                }
+                return static_cast<short>(values.size());
+            });
+        }
+
+        bool push_anything(t_symbol *selector, std::span<const t_atom> atoms = {}) {
+            if (atoms.size() > MaxAtoms) {
+                dropped_count.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            return push(kind::anything, selector, [atoms](t_atom *argv) {
+                std::copy(atoms.begin(), atoms.end(), argv);
+                return static_cast<short>(atoms.size());
+            });
+        }
+
+        [[nodiscard]] size_t dropped() const {
+            return dropped_count.load(std::memory_order_relaxed);
+        }
+
+        operator t_outlet *() const { return outlet; }
+
+    private:
+        enum class kind : unsigned char {
+            bang,
+            int_,
+            float_,
+            list,
+            anything,
+        };
+
+        struct message {
+            kind type;
+            short argc;
+            t_symbol *selector;
+            std::array<t_atom, MaxAtoms> argv;
+        };
+
+        template <typename Fill>
+        bool push(kind type, t_symbol *selector, Fill &&fill) {
+            const bool pushed = queue.try_push([&](message &m) {
+                m.type = type;
+                m.selector = selector;
+                m.argc = fill(m.argv.data());
+            });
+            if (!pushed) {
+                dropped_count.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            qelem_set(qelem);
+            return true;
+        }
+
+        void output(const message &m) const {
+            t_outlet *o = outlet;
+            switch (m.type) {
+                case kind::bang:
+                    outlet_bang(o);
+                    break;
+                case kind::int_:
+                    outlet_int(o, atom_getlong(m.argv.data()));
+                    break;
+                case kind::float_:
+                    outlet_float(o, atom_getfloat(m.argv.data()));
+                    break;
+                case kind::list:
+                    outlet_list(o, nullptr, m.argc, const_cast<t_atom *>(m.argv.data()));
+                    break;
+                case kind::anything:
+                    outlet_anything(o, m.selector, m.argc, m.argv.data());
+                    break;
+            }
+        }
+
+        static void drain(outlet_queue *x) {
+            // copy each message out before outputting it, so that patch code triggered by the output can push
+            // back into this queue without finding its slot still occupied
+            message m;
+            while (x->queue.try_pop([&m](const message &queued) { m = queued; })) {
+                if (x->coalesce == outlet_coalesce::none) {
+                    x->output(m);
+                    continue;
+                }
+                // an int doesn't replace a pending list, nor "set" a pending "clear"
+                auto it = std::find_if(x->latest.begin(), x->latest.end(), [&m](const message &pending) {
+                    return pending.type == m.type && pending.selector == m.selector;
+                });
+                if (it == x->latest.end()) {
+                    x->latest.push_back(m);
+                } else {
+                    *it = m;
+                }
+            }
+            for (const auto &pending: x->latest) {
+                x->output(pending);
+            }
+            x->latest.clear();
+        }
+
+        outlet_handle outlet;
+        detail::mpsc_queue<message> queue;
+        outlet_coalesce coalesce;
+        std::vector<message> latest; // main thread only, one per kind and selector, in order of first arrival
+        std::atomic<size_t> dropped_count{0};
+        t_qelem *qelem;
+    };
+}
+
+#endif //OUTLET_QUEUE_HPP
@@ -0,0 +1,201 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "c74_jitter.h"
+#include "jit_matrix_helpers.hpp"
+#include "named_matrix.hpp"
+#include "tracer.hpp"
+#include "detail/blocking_queue.hpp"
+
+namespace maxutils {
+    using namespace c74::max;
+
+    // A chain of matrix kernels (convert -> blur -> threshold -> ...) where every stage runs on its own thread,
+    // so consecutive frames overlap: while stage 2 works on frame N, stage 1 is already on frame N+1.
+    // Between each pair of stages sits a fixed pool of `depth` intermediate matrices that are handed back and
+    // forth through bounded queues; they are only reallocated when a stage changes their info.
+    class matrix_pipeline {
+    public:
+        using kernel_t = std::function<t_jit_err(t_object *in_matrix, t_object *out_matrix)>;
+        // Adjusts the output info of a stage given its input, e.g. to change type or planecount.
+        // Stages without one output the same info as their input.
+        using info_fn_t = std::function<void(const t_jit_matrix_info &in_info, t_jit_matrix_info &out_info)>;
+
+        explicit matrix_pipeline(size_t depth = 2) : depth{depth < 1 ? 1 : depth} {
+        }
+
+        ~matrix_pipeline() {
+            stop();
+        }
+
+        matrix_pipeline(const matrix_pipeline &) = delete;
+        matrix_pipeline &operator=(const matrix_pipeline &) = delete;
+
+        // name must be a string literal, it is used for trace spans
+        matrix_pipeline &add_stage(const char *name, kernel_t kernel, info_fn_t info_fn = nullptr) {
+            stages.push_back({name, std::move(kernel), std::move(info_fn)});
+            return *this;
+        }
+
+        void start() {
+            if (!threads.empty() || stages.empty()) {
+                return;
+            }
+            for (size_t e = 0; e <= stages.size(); ++e) {
+                edges.push_back(std::make_unique<edge>(depth));
+            }
+            for (size_t s = 0; s < stages.size(); ++s) {
+                threads.emplace_back([this, s] { run_stage(s); });
+            }
+        }
+
+        void stop() {
+            for (auto &e: edges) {
+                e->free.close();
+                e->filled.close();
+            }
+            for (auto &t: threads) {
+                t.join();
+            }
+            threads.clear();
+            edges.clear();
+            allocated = false;
+        }
+
+        // Copies in_matrix into the pipeline. Returns false (dropping the frame) if the first stage is still
+        // busy with every input buffer, so the scheduler never waits on the pipeline.
+        bool submit(t_object *in_matrix) {
+            if (threads.empty()) {
+                return false;
+            }
+            if (!allocated) {
+                allocate(in_matrix);
+            }
+            auto buffer = edges.front()->free.try_pop();
+            if (!buffer) {
+                ++dropped_frames;
+                return false;
+            }
+            {
+                trace_scope span{"pipeline submit", "pipeline"};
+                MatrixLock lock{in_matrix};
+                jit_matrix_copy_adapt((t_object *) (*buffer)->matrix, in_matrix);
+            }
+            edges.front()->filled.push(*buffer);
+            return true;
+        }
+
+        // Copies the most recent finished frame into out_matrix. Returns false if nothing new has finished.
+        bool collect(t_object *out_matrix) {
+            if (edges.empty()) {
+                return false;
+            }
+            auto &last = *edges.back();
+            NamedMatrix *latest = nullptr;
+            while (auto buffer = last.filled.try_pop()) {
+                if (latest) {
+                    last.free.push(latest);
+                }
+                latest = *buffer;
+            }
+            if (!latest) {
+                return false;
+            }
+            {
+                trace_scope span{"pipeline collect", "pipeline"};
+                MatrixLock lock{out_matrix};
+                jit_matrix_copy_adapt(out_matrix, (t_object *) latest->matrix);
+            }
+            last.free.push(latest);
+            return true;
+        }
+
+        [[nodiscard]] size_t dropped() const {
+            return dropped_frames;
+        }
+
+        // Error returned by the most recent failing stage, cleared on read.
+        t_jit_err last_error() {
+            return stage_err.exchange(JIT_ERR_NONE);
+        }
+
+    private:
+        struct stage {
+            const char *name;
+            kernel_t kernel;
+            info_fn_t info_fn;
+        };
+
+        struct edge {
+            explicit edge(size_t depth) : free{depth}, filled{depth} {
+            }
+
+            std::vector<std::unique_ptr<NamedMatrix>> buffers;
+            detail::blocking_queue<NamedMatrix *> free;
+            detail::blocking_queue<NamedMatrix *> filled;
+        };
+
+        void allocate(t_object *in_matrix) {
+            t_jit_matrix_info info;
+            jit_object_method(in_matrix, _jit_sym_getinfo, &info);
+            for (auto &e: edges) {
+                for (size_t i = 0; i < depth; ++i) {
+                    e->buffers.push_back(std::make_unique<NamedMatrix>(&info));
+                    e->free.push(e->buffers.back().get());
+                }
+            }
+            allocated = true;
+        }
+
+        void run_stage(size_t s) {
+            const stage &st = stages[s];
+            edge &in_edge = *edges[s];
+            edge &out_edge = *edges[s + 1];
+            while (auto in = in_edge.filled.pop()) {
+                auto out = out_edge.free.pop();
+                if (!out) {
+                    return;
+                }
+                auto in_matrix = (t_object *) (*in)->matrix;
+                auto out_matrix = (t_object *) (*out)->matrix;
+                {
+                    MatrixLock lock{in_matrix, out_matrix};
+                    t_jit_matrix_info in_info, out_info;
+                    jit_object_method(in_matrix, _jit_sym_getinfo, &in_info);
+                    out_info = in_info;
+                    if (st.info_fn) {
+                        st.info_fn(in_info, out_info);
+                    }
+                    jit_object_method(out_matrix, _jit_sym_setinfo, &out_info);
+
+                    trace_scope span{st.name, "pipeline"};
+                    if (auto err = st.kernel(in_matrix, out_matrix)) {
+                        stage_err.store(err);
+                    }
+                }
+                in_edge.free.push(*in);
+                out_edge.filled.push(*out);
+            }
+        }
+
+        size_t depth;
+        std::vector<stage> stages;
+        std::vector<std::unique_ptr<edge>> edges;
+        std::vector<std::thread> threads;
+        std::atomic<t_jit_err> stage_err{JIT_ERR_NONE};
+        size_t dropped_frames = 0;
+        bool allocated = false;
+    };
+}
+
+#endif //PIPELINE_HPP
@@ -0,0 +1,185 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <string>
+
+#include "ext.h"
+#include "attributes.hpp"
+#include "detail/clock.hpp"
+#include "detail/member_pointer.hpp"
+
+namespace maxutils {
+    using namespace c74::max;
+
+    // Log-linear latency histogram in the spirit of HdrHistogram: exact below 8ns, then 8 sub-buckets per
+    // power of two (~12% precision) up to about 18 minutes. Counters are relaxed atomics split over a few
+    // shards so concurrent writers (e.g. jitter's parallel workers) rarely touch the same cache lines.
+    // All-zero memory is a valid empty histogram, so it can sit inside an object_alloc'ed struct.
+    class latency_histogram {
+    public:
+        static constexpr unsigned sub_bucket_bits = 3;
+        static constexpr unsigned sub_bucket_count = 1u << sub_bucket_bits;
+        static constexpr unsigned max_magnitude = 40;
+        static constexpr size_t bucket_count = (max_magnitude - sub_bucket_bits + 1) * sub_bucket_count;
+        static constexpr size_t shard_count = 4;
+
+        void record(uint64_t ns) {
+            auto &shard = shards[shard_index()];
+            shard.counts[bucket_for(ns)].fetch_add(1, std::memory_order_relaxed);
+            uint64_t current = max_ns.load(std::memory_order_relaxed);
+            while (ns > current && !max_ns.compare_exchange_weak(current, ns, std::memory_order_relaxed)) {
+            }
+        }
+
+        [[nodiscard]] uint64_t count() const {
+            uint64_t total = 0;
+            for (const auto &shard: shards) {
+                for (const auto &c: shard.counts) {
+                    total += c.load(std::memory_order_relaxed);
+                }
+            }
+            return total;
+        }
+
+        [[nodiscard]] uint64_t max() const {
+            return max_ns.load(std::memory_order_relaxed);
+        }
+
+        // Value at quantile q (0-1) in nanoseconds, reported as the middle of the bucket it falls in.
+        [[nodiscard]] uint64_t percentile(double q) const {
+            std::array<uint64_t, bucket_count> merged{};
+            uint64_t total = 0;
+            for (const auto &shard: shards) {
+                for (size_t i = 0; i < bucket_count; ++i) {
+                    const uint64_t c = shard.counts[i].load(std::memory_order_relaxed);
+                    merged[i] += c;
+                    total += c;
+                }
+            }
+            if (total == 0) {
+                return 0;
+            }
+            const auto rank = static_cast<uint64_t>(q * static_cast<double>(total - 1)) + 1;
+            uint64_t seen = 0;
+            for (size_t i = 0; i < bucket_count; ++i) {
+                seen += merged[i];
+                if (seen >= rank) {
+                    return std::min(bucket_middle(i), max());
+                }
+            }
+            return max();
+        }
+
+        void reset() {
+            for (auto &shard: shards) {
+                for (auto &c: shard.counts) {
+                    c.store(0, std::memory_order_relaxed);
+                }
+            }
+            max_ns.store(0, std::memory_order_relaxed);
+        }
+
+        static constexpr size_t bucket_for(uint64_t ns) {
+            if (ns < sub_bucket_count) {
+                return ns;
+            }
+            const unsigned magnitude = std::bit_width(ns) - 1;
+            if (magnitude >= max_magnitude) {
+                return bucket_count - 1;
+            }
+            const unsigned sub = (ns >> (magnitude - sub_bucket_bits)) & (sub_bucket_count - 1);
+            return (magnitude - sub_bucket_bits + 1) * sub_bucket_count + sub;
+        }
+
+        static uint64_t bucket_middle(size_t bucket) {
+            if (bucket < sub_bucket_count) {
+                return bucket;
+            }
+            const size_t m = bucket / sub_bucket_count;
+            const uint64_t width = uint64_t{1} << (m - 1);
+            const uint64_t lower = (sub_bucket_count + bucket % sub_bucket_count) * width;
+            return lower + width / 2;
+        }
+
+    private:
+        static size_t shard_index() {
+            static std::atomic<size_t> next_shard{0};
+            static thread_local const size_t index = next_shard.fetch_add(1, std::memory_order_relaxed) % shard_count;
+            return index;
+        }
+
+        struct alignas(64) shard {
+            std::array<std::atomic<uint64_t>, bucket_count> counts;
+        };
+
+        std::array<shard, shard_count> shards;
+        std::atomic<uint64_t> max_ns;
+    };
+
+    // The last magnitude below max_magnitude fills the table exactly; anything longer clamps to the top bucket.
+    static_assert(latency_histogram::bucket_for((uint64_t{1} << latency_histogram::max_magnitude) - 1)
+                  == latency_histogram::bucket_count - 1);
+    static_assert(latency_histogram::bucket_for(uint64_t{1} << latency_histogram::max_magnitude)
+                  == latency_histogram::bucket_count - 1);
+    static_assert(latency_histogram::bucket_for(UINT64_MAX) == latency_histogram::bucket_count - 1);
+
+    class scoped_timer {
+    public:
+        explicit scoped_timer(latency_histogram &histogram) : histogram{histogram}, start{detail::now_ns()} {
+        }
+
+        ~scoped_timer() {
+            histogram.record(detail::now_ns() - start);
+        }
+
+        scoped_timer(const scoped_timer &) = delete;
+        scoped_timer &operator=(const scoped_timer &) = delete;
+
+    private:
+        latency_histogram &histogram;
+        uint64_t start;
+    };
+
+    // Wraps a matrix_calc-style method so that every call is timed into the object's histogram, e.g.
+    //     class_addmethod(c, (method) maxutils::profiled<&t_obj::calc_time, my_matrix_calc>::call, "matrix_calc", A_CANT, 0);
+    template <auto histogram_ptr, auto fn>
+    struct profiled;
+
+    template <auto histogram_ptr, typename Ret, typename Object, typename ...Args, Ret (*fn)(Object *, Args...)>
+    struct profiled<histogram_ptr, fn> {
+        static Ret call(Object *x, Args ...args) {
+            scoped_timer timer{x->*histogram_ptr};
+            return fn(x, args...);
+        }
+    };
+
+    // Registers read-only <prefix>_p50, <prefix>_p99 and <prefix>_max attributes (in microseconds).
+    template <auto histogram_ptr>
+    void create_profiler_attrs(t_class *c, const std::string &prefix = "calc") {
+        using object_t = detail::member_pointer_object_type_t<histogram_ptr>;
+        const auto reject = [](object_t *x, double) -> err_t {
+            object_error((t_object *) x, "Profiler attributes are read-only");
+            return MAX_ERR_GENERIC;
+        };
+        create_attr(c, prefix + "_p50", [](object_t *x) -> double {
+            return (x->*histogram_ptr).percentile(0.5) / 1000.0;
+        }, +reject).readonly();
+        create_attr(c, prefix + "_p99", [](object_t *x) -> double {
+            return (x->*histogram_ptr).percentile(0.99) / 1000.0;
+        }, +reject).readonly();
+        create_attr(c, prefix + "_max", [](object_t *x) -> double {
+            return (x->*histogram_ptr).max() / 1000.0;
+        }, +reject).readonly();
+    }
+}
+
+#endif //PROFILER_HPP
@@ -0,0 +1,370 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef RANK_FILTER_HPP
+#define RANK_FILTER_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "c74_jitter.h"
+#include "jit_matrix_view_v2.hpp"
+#include "tracer.hpp"
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+
+namespace maxutils {
+    using namespace c74::max;
+
+    namespace detail {
+        // Batcher's odd-even merge sort for P (a power of two) inputs, as compare-exchange pairs.
+        template <size_t P>
+        constexpr size_t network_size() {
+            size_t count = 0;
+            for (size_t p = 1; p < P; p <<= 1) {
+                for (size_t k = p; k >= 1; k >>= 1) {
+                    for (size_t j = k % p; j + k < P; j += 2 * k) {
+                        for (size_t i = 0; i < k && i + j + k < P; ++i) {
+                            if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+                                ++count;
+                            }
+                        }
+                    }
+                }
+            }
+            return count;
+        }
+
+        template <size_t P>
+        constexpr auto sorting_network() {
+            std::array<std::pair<uint8_t, uint8_t>, network_size<P>()> pairs{};
+            size_t n = 0;
+            for (size_t p = 1; p < P; p <<= 1) {
+                for (size_t k = p; k >= 1; k >>= 1) {
+                    for (size_t j = k % p; j + k < P; j += 2 * k) {
+                        for (size_t i = 0; i < k && i + j + k < P; ++i) {
+                            if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+                                pairs[n++] = {static_cast<uint8_t>(i + j), static_cast<uint8_t>(i + j + k)};
+                            }
+                        }
+                    }
+                }
+            }
+            return pairs;
+        }
+
+        inline float min(float a, float b) {
+            return std::min(a, b);
+        }
+
+        inline float max(float a, float b) {
+            return std::max(a, b);
+        }
+
+        // Sorts v ascending, unrolled so the values stay in registers; V is float or f32x4 (four windows at once).
+        template <size_t P, typename V>
+        void sort_window(V (&v)[P]) {
+            static constexpr auto pairs = sorting_network<P>();
+            const auto exchange = [](V &a, V &b) {
+                const V low = min(a, b);
+                b = max(a, b);
+                a = low;
+            };
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                (exchange(v[pairs[I].first], v[pairs[I].second]), ...);
+            }(std::make_index_sequence<pairs.size()>{});
+        }
+
+        struct rank_window {
+            long rx;
+            long ry;
+            long k; // rank as an index into the sorted window
+        };
+
+        // Source rows for output row y (clamped at the edges), planes interleaved.
+        template <typename T>
+        void window_rows(matrix_view<T> &src, long y, long ry, long h, const T **rows) {
+            for (long dy = -ry; dy <= ry; ++dy) {
+                rows[dy + ry] = src.row(std::clamp(y + dy, 0l, h - 1)).as_1d_span().data();
+            }
+        }
+
+        // Float windows of up to 5x5 through a sorting network: four single-plane cells per step, or one
+        // 4-plane cell per step with the planes in the lanes; everything else (and the edges) one value at a
+        // time.
+        template <size_t P>
+        void rank_rows_network(matrix_view<float> &src, matrix_view<float> &dst, rank_window win, long y0, long y1) {
+            const long w = src.ncols(), h = src.dimcount() > 1 ? src.nrows() : 1;
+            const long planes = static_cast<long>(src.planecount());
+            const long n = (2 * win.rx + 1) * (2 * win.ry + 1);
+            constexpr float inf = std::numeric_limits<float>::infinity();
+            const float *rows[5];
+            auto scalar = [&](long x, long p) {
+                float v[P];
+                long i = 0;
+                for (long dy = 0; dy <= 2 * win.ry; ++dy) {
+                    for (long dx = -win.rx; dx <= win.rx; ++dx) {
+                        v[i++] = rows[dy][std::clamp(x + dx, 0l, w - 1) * planes + p];
+                    }
+                }
+                std::fill(v + n, v + P, inf);
+                sort_window(v);
+                return v[win.k];
+            };
+            auto simd = [&](auto &&offset) {
+                f32x4 v[P];
+                long i = 0;
+                for (long dy = 0; dy <= 2 * win.ry; ++dy) {
+                    for (long dx = -win.rx; dx <= win.rx; ++dx) {
+                        v[i++] = f32x4::load(rows[dy] + offset(dx));
+                    }
+                }
+                std::fill(v + n, v + P, f32x4::set1(inf));
+                sort_window(v);
+                return v[win.k];
+            };
+            for (long y = y0; y < y1; ++y) {
+                window_rows(src, y, win.ry, h, rows);
+                float *out = dst.row(y).as_1d_span().data();
+                long x = 0;
+                if (planes == 1) {
+                    for (; x < std::min(win.rx, w); ++x) {
+                        out[x] = scalar(x, 0);
+                    }
+                    for (; x + 4 + win.rx <= w; x += 4) {
+                        simd([x](long dx) { return x + dx; }).store(out + x);
+                    }
+                } else if (planes == 4) {
+                    for (; x < std::min(win.rx, w); ++x) {
+                        for (long p = 0; p < 4; ++p) {
+                            out[x * 4 + p] = scalar(x, p);
+                        }
+                    }
+                    for (; x + win.rx < w; ++x) {
+                        simd([x](long dx) { return (x + dx) * 4; }).store(out + x * 4);
+                    }
+                }
+                for (; x < w; ++x) {
+                    for (long p = 0; p < planes; ++p) {
+                        out[x * planes + p] = scalar(x, p);
+                    }
+                }
+            }
+        }
+
+        // Char windows in constant time per cell (Perreault & Hebert): a 256-bin histogram per column covering
+        // the window's rows slides down with the rows, and the window's histogram slides along each row by
+        // adding the column entering it and subtracting the one leaving. A 16-bin coarse level makes finding
+        // the k-th value two short scans.
+        class rank_histogram {
+        public:
+            void prepare(long w) {
+                const size_t size = w * bins_per_column;
+                if (columns.size() < size) {
+                    columns.resize(size);
+                }
+            }
+
+            void clear_columns(long w) {
+                std::fill_n(columns.begin(), w * bins_per_column, uint16_t{0});
+            }
+
+            void column_add(long x, unsigned char v) {
+                uint16_t *c = columns.data() + x * bins_per_column;
+                ++c[v];
+                ++c[256 + (v >> 4)];
+            }
+
+            void column_remove(long x, unsigned char v) {
+                uint16_t *c = columns.data() + x * bins_per_column;
+                --c[v];
+                --c[256 + (v >> 4)];
+            }
+
+            void clear_window() {
+                window.fill(0);
+            }
+
+            void window_add(long x) {
+                const uint16_t *c = columns.data() + x * bins_per_column;
+                for (size_t i = 0; i < bins_per_column; i += 8) {
+                    (u16x8::load(window.data() + i) + u16x8::load(c + i)).store(window.data() + i);
+                }
+            }
+
+            // Moves the window along by a column: removes column `out`, adds column `in`.
+            void window_slide(long out, long in) {
+                const uint16_t *o = columns.data() + out * bins_per_column;
+                const uint16_t *n = columns.data() + in * bins_per_column;
+                for (size_t i = 0; i < bins_per_column; i += 8) {
+                    (u16x8::load(window.data() + i) + u16x8::load(n + i) - u16x8::load(o + i)).store(window.data() + i);
+                }
+            }
+
+            [[nodiscard]] unsigned char select(long k) const {
+                long coarse = 0;
+                for (; coarse < 15 && k >= window[256 + coarse]; ++coarse) {
+                    k -= window[256 + coarse];
+                }
+                long v = coarse * 16;
+                for (; v < coarse * 16 + 15 && k >= window[v]; ++v) {
+                    k -= window[v];
+                }
+                return static_cast<unsigned char>(v);
+            }
+
+            static constexpr size_t bins_per_column = 256 + 16;
+
+        private:
+            std::vector<uint16_t> columns;
+            std::array<uint16_t, bins_per_column> window;
+        };
+
+        inline void rank_rows_histogram(matrix_view<char> &src, matrix_view<char> &dst, rank_window win,
+                                        long y0, long y1) {
+            static thread_local rank_histogram hist;
+            const long w = src.ncols(), h = src.dimcount() > 1 ? src.nrows() : 1;
+            const long planes = static_cast<long>(src.planecount());
+            const auto at = [&](long x, long y, long p) {
+                return static_cast<unsigned char>(src.row(std::clamp(y, 0l, h - 1)).as_1d_span()[x * planes + p]);
+            };
+            hist.prepare(w);
+            for (long p = 0; p < planes; ++p) {
+                hist.clear_columns(w);
+                for (long x = 0; x < w; ++x) {
+                    for (long dy = -win.ry; dy <= win.ry; ++dy) {
+                        hist.column_add(x, at(x, y0 + dy, p));
+                    }
+                }
+                for (long y = y0; y < y1; ++y) {
+                    if (y > y0) {
+                        for (long x = 0; x < w; ++x) {
+                            hist.column_remove(x, at(x, y - win.ry - 1, p));
+                            hist.column_add(x, at(x, y + win.ry, p));
+                        }
+                    }
+                    hist.clear_window();
+                    for (long dx = -win.rx; dx <= win.rx; ++dx) {
+                        hist.window_add(std::clamp(dx, 0l, w - 1));
+                    }
+                    char *out = dst.row(y).as_1d_span().data();
+                    for (long x = 0; x < w; ++x) {
+                        out[x * planes + p] = static_cast<char>(hist.select(win.k));
+                        if (x + 1 < w) {
+                            hist.window_slide(std::max(x - win.rx, 0l), std::min(x + win.rx + 1, w - 1));
+                        }
+                    }
+                }
+            }
+        }
+
+        // Anything else: gather the window and partially sort it.
+        template <typename T>
+        void rank_rows_select(matrix_view<T> &src, matrix_view<T> &dst, rank_window win, long y0, long y1) {
+            using value_t = std::conditional_t<std::is_same_v<T, char>, unsigned char, T>;
+            static thread_local std::vector<value_t> window;
+            const long w = src.ncols(), h = src.dimcount() > 1 ? src.nrows() : 1;
+            const long planes = static_cast<long>(src.planecount());
+            window.resize((2 * win.rx + 1) * (2 * win.ry + 1));
+            for (long y = y0; y < y1; ++y) {
+                T *out = dst.row(y).as_1d_span().data();
+                for (long x = 0; x < w; ++x) {
+                    for (long p = 0; p < planes; ++p) {
+                        size_t i = 0;
+                        for (long dy = -win.ry; dy <= win.ry; ++dy) {
+                            const T *row = src.row(std::clamp(y + dy, 0l, h - 1)).as_1d_span().data();
+                            for (long dx = -win.rx; dx <= win.rx; ++dx) {
+                                window[i++] = static_cast<value_t>(row[std::clamp(x + dx, 0l, w - 1) * planes + p]);
+                            }
+                        }
+                        std::nth_element(window.begin(), window.begin() + win.k, window.end());
+                        out[x * planes + p] = static_cast<T>(window[win.k]);
+                    }
+                }
+            }
+        }
+    }
+
+    // Replaces each cell with the value at `rank` (0 for the minimum, 0.5 the median, 1 the maximum) of the
+    // (2 * radius_x + 1) x (2 * radius_y + 1) window around it, per plane, edges clamped. char uses
+    // constant-time sliding histograms, float windows up to 5x5 a SIMD sorting network, and other types or
+    // sizes a per-cell partial sort. Rows are spread over the thread pool; src and dst must not overlap.
+    template <typename T>
+    t_jit_err rank_filter(matrix_view<T> &src, matrix_view<T> &dst, long radius_x, long radius_y, double rank) {
+        if (src.overlaps(dst)) {
+            return JIT_ERR_INVALID_OUTPUT;
+        }
+        if (src.planecount() != dst.planecount()) {
+            return JIT_ERR_MISMATCH_PLANE;
+        }
+        if (src.dimcount() > 2 || src.dimcount() != dst.dimcount() || src.ncols() != dst.ncols()
+            || (src.dimcount() == 2 && src.nrows() != dst.nrows())) {
+            return JIT_ERR_MISMATCH_DIM;
+        }
+        if (radius_x < 0 || radius_y < 0 || !(rank >= 0 && rank <= 1)) {
+            return JIT_ERR_INVALID_INPUT;
+        }
+        trace_scope span{"rank_filter", "matrix"};
+        const long h = src.dimcount() > 1 ? src.nrows() : 1;
+        if (h == 1) {
+            radius_y = 0;
+        }
+        const long n = (2 * radius_x + 1) * (2 * radius_y + 1);
+        const detail::rank_window win{radius_x, radius_y, std::lround(rank * (n - 1))};
+
+        const auto rows = [&](auto &&kernel) {
+            // chunks start by filling the column histograms, so they want to be a good number of rows
+            detail::parallel_for(0, h, std::is_same_v<T, char> ? 32 : 4, [&](size_t begin, size_t end) {
+                kernel(src, dst, win, static_cast<long>(begin), static_cast<long>(end));
+            });
+        };
+        if constexpr (std::is_same_v<T, char>) {
+            // window counts have to fit the 16-bit bins
+            if (n <= std::numeric_limits<uint16_t>::max()) {
+                rows(detail::rank_rows_histogram);
+                return JIT_ERR_NONE;
+            }
+        } else if constexpr (std::is_same_v<T, float>) {
+            if (radius_x <= 2 && radius_y <= 2) {
+                if (n <= 16) {
+                    rows(detail::rank_rows_network<16>);
+                } else {
+                    rows(detail::rank_rows_network<32>);
+                }
+                return JIT_ERR_NONE;
+            }
+        }
+        rows(detail::rank_rows_select<T>);
+        return JIT_ERR_NONE;
+    }
+
+    template <typename T>
+    t_jit_err median_filter(matrix_view<T> &src, matrix_view<T> &dst, long radius) {
+        return rank_filter(src, dst, radius, radius, 0.5);
+    }
+
+    template <typename T>
+    t_jit_err min_filter(matrix_view<T> &src, matrix_view<T> &dst, long radius) {
+        return rank_filter(src, dst, radius, radius, 0.0);
+    }
+
+    template <typename T>
+    t_jit_err max_filter(matrix_view<T> &src, matrix_view<T> &dst, long radius) {
+        return rank_filter(src, dst, radius, radius, 1.0);
+    }
+
+    // percentile from 0 to 100
+    template <typename T>
+    t_jit_err percentile_filter(matrix_view<T> &src, matrix_view<T> &dst, long radius, double percentile) {
+        return rank_filter(src, dst, radius, radius, percentile / 100.0);
+    }
+}
+
+#endif //RANK_FILTER_HPP
@@ -0,0 +1,330 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef RESAMPLE_HPP
+#define RESAMPLE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <type_traits>
+#include <vector>
+
+#include "c74_jitter.h"
+#include "jit_matrix_helpers.hpp"
+#include "jit_matrix_view_v2.hpp"
+#include "tracer.hpp"
+#include "visit_matrix.hpp"
+#include "detail/cell_convert.hpp"
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+
+namespace maxutils {
+    using namespace c74::max;
+
+    enum class resample_filter {
+        nearest,
+        bilinear,
+        bicubic, // Catmull-Rom
+        area,    // box average over the covered source cells, for downscaling without aliasing
+    };
+
+    namespace detail {
+        // For every destination index along one axis: `width` clamped source indices and their weights.
+        struct resample_taps {
+            long src_size = 0;
+            long dst_size = 0;
+            resample_filter filter = resample_filter::nearest;
+            long width = 0;
+            std::vector<long> index;
+            std::vector<float> weight;
+
+            void build(long src, long dst, resample_filter f) {
+                src_size = src;
+                dst_size = dst;
+                filter = f;
+                const double scale = static_cast<double>(src) / static_cast<double>(dst);
+                switch (f) {
+                    case resample_filter::nearest: width = 1; break;
+                    case resample_filter::bilinear: width = 2; break;
+                    case resample_filter::bicubic: width = 4; break;
+                    case resample_filter::area: width = std::max(2l, static_cast<long>(std::ceil(scale)) + 1); break;
+                }
+                index.assign(dst * width, 0);
+                weight.assign(dst * width, 0.0f);
+
+                for (long d = 0; d < dst; ++d) {
+                    long *idx = index.data() + d * width;
+                    float *w = weight.data() + d * width;
+                    const double centre = (d + 0.5) * scale - 0.5;
+                    const double first = std::floor(centre);
+                    const double t = centre - first;
+                    switch (f) {
+                        case resample_filter::nearest:
+                            idx[0] = static_cast<long>((d + 0.5) * scale);
+                            w[0] = 1.0f;
+                            break;
+                        case resample_filter::bilinear:
+                            idx[0] = static_cast<long>(first);
+                            idx[1] = idx[0] + 1;
+                            w[0] = static_cast<float>(1.0 - t);
+                            w[1] = static_cast<float>(t);
+                            break;
+                        case resample_filter::bicubic:
+                            for (long k = 0; k < 4; ++k) {
+                                idx[k] = static_cast<long>(first) - 1 + k;
+                                w[k] = static_cast<float>(cubic(std::abs(t + 1.0 - k)));
+                            }
+                            break;
+                        case resample_filter::area: {
+                            const double lo = d * scale;
+                            const double hi = (d + 1) * scale;
+                            const long base = static_cast<long>(std::floor(lo));
+                            for (long k = 0; k < width; ++k) {
+                                const double overlap = std::min(hi, base + k + 1.0) - std::max(lo, base + k + 0.0);
+                                idx[k] = base + k;
+                                w[k] = static_cast<float>(std::max(0.0, overlap) / scale);
+                            }
+                            break;
+                        }
+                    }
+                    for (long k = 0; k < width; ++k) {
+                        idx[k] = std::clamp(idx[k], 0l, src - 1);
+                    }
+                }
+            }
+
+            [[nodiscard]] bool matches(long src, long dst, resample_filter f) const {
+                return src == src_size && dst == dst_size && f == filter;
+            }
+
+        private:
+            static double cubic(double x) {
+                constexpr double a = -0.5;
+                if (x <= 1.0) {
+                    return ((a + 2.0) * x - (a + 3.0)) * x * x + 1.0;
+                }
+                if (x < 2.0) {
+                    return ((a * x - 5.0 * a) * x + 8.0 * a) * x - 4.0 * a;
+                }
+                return 0.0;
+            }
+        };
+
+        // char and float32 accumulate in float (and use f32x4), long and float64 in double to keep their precision
+        template <typename T>
+        using resample_acc_t = std::conditional_t<std::is_same_v<T, char> || std::is_same_v<T, float>, float, double>;
+
+        inline f32x4 load_f32x4(const float *p) {
+            return f32x4::load(p);
+        }
+
+        inline f32x4 load_f32x4(const char *p) {
+            auto u = reinterpret_cast<const unsigned char *>(p);
+            return f32x4::set(u[0], u[1], u[2], u[3]);
+        }
+
+        template <typename T>
+        struct resample_row {
+            const T *data;
+            float weight;
+        };
+
+        template <typename Acc>
+        std::vector<Acc> &resample_scratch() {
+            static thread_local std::vector<Acc> scratch;
+            return scratch;
+        }
+
+        template <typename T>
+        std::vector<resample_row<T>> &resample_rows() {
+            static thread_local std::vector<resample_row<T>> rows;
+            return rows;
+        }
+    }
+
+    // Separable resampler: each output row blends the source rows it needs into a float scratch row, then
+    // applies the horizontal taps to that. Taps are cached per axis, so resampling a stream of frames
+    // between the same sizes only computes them once. Rows are spread over the maxutils thread pool.
+    class resampler {
+    public:
+        template <typename T>
+        t_jit_err operator()(matrix_view<T> &src, matrix_view<T> &dst, resample_filter filter) {
+            if (src.planecount() != dst.planecount()) {
+                return JIT_ERR_MISMATCH_PLANE;
+            }
+            if (src.dimcount() != dst.dimcount() || src.dimcount() > 2) {
+                return JIT_ERR_MISMATCH_DIM;
+            }
+            trace_scope span{"resample", "matrix"};
+
+            const long planes = static_cast<long>(src.planecount());
+            const long src_w = src.ncols();
+            const long dst_w = dst.ncols();
+            const long src_h = src.dimcount() > 1 ? src.nrows() : 1;
+            const long dst_h = dst.dimcount() > 1 ? dst.nrows() : 1;
+            if (src_w < 1 || src_h < 1 || dst_w < 1 || dst_h < 1) {
+                return JIT_ERR_NONE;
+            }
+            if (!x_taps.matches(src_w, dst_w, filter)) {
+                x_taps.build(src_w, dst_w, filter);
+            }
+            if (!y_taps.matches(src_h, dst_h, filter)) {
+                y_taps.build(src_h, dst_h, filter);
+            }
+
+            // aim for chunks of roughly 16k output values
+            const size_t grain = std::max(1l, (1l << 14) / std::max(1l, dst_w * planes));
+            const auto &xt = x_taps;
+            const auto &yt = y_taps;
+
+            if (filter == resample_filter::nearest) {
+                detail::parallel_for(0, dst_h, grain, [&](size_t begin, size_t end) {
+                    for (size_t y = begin; y < end; ++y) {
+                        const T *in = src.row(yt.index[y]).as_1d_span().data();
+                        T *out = dst.row(y).as_1d_span().data();
+                        for (long x = 0; x < dst_w; ++x) {
+                            std::copy_n(in + xt.index[x] * planes, planes, out + x * planes);
+                        }
+                    }
+                });
+                return JIT_ERR_NONE;
+            }
+
+            detail::parallel_for(0, dst_h, grain, [&](size_t begin, size_t end) {
+                using acc_t = detail::resample_acc_t<T>;
+                auto &scratch = detail::resample_scratch<acc_t>();
+                scratch.resize(src_w * planes);
+                auto &rows = detail::resample_rows<T>();
+                for (size_t y = begin; y < end; ++y) {
+                    rows.clear();
+                    for (long k = 0; k < yt.width; ++k) {
+                        if (const float w = yt.weight[y * yt.width + k]; w != 0.0f) {
+                            rows.push_back({src.row(yt.index[y * yt.width + k]).as_1d_span().data(), w});
+                        }
+                    }
+                    blend_rows(rows, scratch.data(), src_w * planes);
+                    apply_columns(scratch.data(), dst.row(y).as_1d_span().data(), xt, planes);
+                }
+            });
+            return JIT_ERR_NONE;
+        }
+
+    private:
+        template <typename T, typename Acc>
+        static void blend_rows(const std::vector<detail::resample_row<T>> &rows, Acc *out, long n) {
+            long i = 0;
+            if constexpr (std::is_same_v<Acc, float>) {
+                for (; i + 4 <= n; i += 4) {
+                    auto acc = detail::f32x4::zero();
+                    for (const auto &r: rows) {
+                        acc = fma(acc, detail::f32x4::set1(r.weight), detail::load_f32x4(r.data + i));
+                    }
+                    acc.store(out + i);
+                }
+            }
+            for (; i < n; ++i) {
+                Acc acc = 0;
+                for (const auto &r: rows) {
+                    acc += r.weight * detail::cell_to<Acc>(r.data[i]);
+                }
+                out[i] = acc;
+            }
+        }
+
+        template <typename T, typename Acc>
+        static void apply_columns(const Acc *in, T *out, const detail::resample_taps &xt, long planes) {
+            const long width = xt.width;
+            if constexpr (std::is_same_v<Acc, float>) {
+                if (planes == 4) {
+                    for (long x = 0; x < xt.dst_size; ++x) {
+                        const long *idx = xt.index.data() + x * width;
+                        const float *w = xt.weight.data() + x * width;
+                        auto acc = detail::f32x4::zero();
+                        for (long k = 0; k < width; ++k) {
+                            acc = fma(acc, detail::f32x4::set1(w[k]), detail::f32x4::load(in + idx[k] * 4));
+                        }
+                        float cell[4];
+                        acc.store(cell);
+                        for (long p = 0; p < 4; ++p) {
+                            out[x * 4 + p] = detail::cell_from<T>(cell[p]);
+                        }
+                    }
+                    return;
+                }
+            }
+            for (long x = 0; x < xt.dst_size; ++x) {
+                const long *idx = xt.index.data() + x * width;
+                const float *w = xt.weight.data() + x * width;
+                for (long p = 0; p < planes; ++p) {
+                    Acc acc = 0;
+                    for (long k = 0; k < width; ++k) {
+                        acc += w[k] * in[idx[k] * planes + p];
+                    }
+                    out[x * planes + p] = detail::cell_from<T>(acc);
+                }
+            }
+        }
+
+        detail::resample_taps x_taps;
+        detail::resample_taps y_taps;
+    };
+
+    namespace detail {
+        inline resampler &thread_resampler() {
+            static thread_local resampler instance;
+            return instance;
+        }
+    }
+
+    // Resamples src into dst's current dims. Both views must have the same type, planecount and dimcount (1 or 2).
+    template <typename T>
+    t_jit_err resample(matrix_view<T> src, matrix_view<T> dst, resample_filter filter = resample_filter::bilinear) {
+        return detail::thread_resampler()(src, dst, filter);
+    }
+
+    // As above for locked matrix objects of any (matching) type.
+    inline t_jit_err resample(t_object *src, t_object *dst, resample_filter filter = resample_filter::bilinear) {
+        return visit_matrices({src, dst}, [filter](auto &src_view, auto &dst_view, long) {
+            return resample(src_view, dst_view, filter);
+        });
+    }
+
+    // MOP ioproc that resamples incoming matrices to the input's own dims (set with dimlink off, e.g. @dim on
+    // the inlet) instead of truncating them like jit_mop_ioproc_copy_trunc. The input follows the incoming
+    // type and planecount; its matrix is only reconfigured when those change, so dim changes upstream never
+    // reallocate it. Incoming matrices the input restricts to another type/planecount, or with a different
+    // dimcount, fall back to jit_mop_ioproc_copy_trunc.
+    // Install with JitMopIO::get_input(mop, 1).no_dimlink().use_ioproc_custom_fn(ioproc_resample<...>).
+    template <resample_filter Filter = resample_filter::bilinear>
+    t_jit_err ioproc_resample(void *mop, void *mop_io, void *matrix) {
+        auto io_matrix = (t_object *) jit_object_method(mop_io, _jit_sym_getmatrix);
+        if (!matrix_pointers_are_valid(matrix, io_matrix)) {
+            return JIT_ERR_NONE;
+        }
+        auto in_matrix = (t_object *) matrix;
+
+        t_jit_matrix_info in_info, io_info, wanted;
+        jit_object_method(in_matrix, _jit_sym_getinfo, &in_info);
+        jit_object_method(io_matrix, _jit_sym_getinfo, &io_info);
+        wanted = in_info;
+        jit_object_method(mop_io, _jit_sym_restrict_type, &wanted);
+        jit_object_method(mop_io, _jit_sym_restrict_planecount, &wanted);
+        if (wanted.type != in_info.type || wanted.planecount != in_info.planecount
+            || io_info.dimcount != in_info.dimcount || in_info.dimcount > 2) {
+            return jit_mop_ioproc_copy_trunc(mop, mop_io, matrix);
+        }
+        if (io_info.type != in_info.type || io_info.planecount != in_info.planecount) {
+            io_info.type = in_info.type;
+            io_info.planecount = in_info.planecount;
+            jit_object_method(io_matrix, _jit_sym_setinfo, &io_info);
+        }
+
+        MatrixLock lock{in_matrix, io_matrix};
+        return resample(in_matrix, io_matrix, Filter);
+    }
+}
+
+#endif //RESAMPLE_HPP
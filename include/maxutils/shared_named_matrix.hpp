@@ -0,0 +1,149 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef SHARED_NAMED_MATRIX_HPP
+#define SHARED_NAMED_MATRIX_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "ext.h"
+#include "c74_jitter.h"
+#include "shm_frame.hpp"
+#include "tracer.hpp"
+
+using namespace c74::max;
+
+// A NamedMatrix whose data lives in a POSIX shared memory segment, so another process can map each frame
+// with shm_frame_reader instead of receiving a serialised copy. The matrix references the slot claimed by
+// begin_frame(); fill it (or use publish(src)) and publish() it. While readers have pinned every slot the
+// matrix references a private scratch buffer instead, so writes never land in a frame readers can see, and
+// that frame is dropped. Tightly packed, so dimstride is the same on both sides.
+class SharedNamedMatrix {
+public:
+    SharedNamedMatrix(const std::string &shm_name, t_jit_matrix_info *info, t_symbol *name = nullptr,
+                      uint32_t slots = 3)
+        : matrix{}, name{}, info{*info}, writer{shm_name, frame_bytes(*info), slots} {
+        this->info.flags = JIT_MATRIX_DATA_REFERENCE | JIT_MATRIX_DATA_PACK_TIGHT | JIT_MATRIX_DATA_FLAGS_USE;
+        matrix = (t_jit_object *) jit_object_new(gensym("jit_matrix"), &this->info);
+        if (!name) name = jit_symbol_unique();
+        jit_object_register(matrix, name);
+        atom_setsym(&this->name, name);
+        begin_frame();
+    }
+
+    SharedNamedMatrix(const SharedNamedMatrix &) = delete;
+    SharedNamedMatrix &operator=(const SharedNamedMatrix &) = delete;
+    SharedNamedMatrix(SharedNamedMatrix &&) = delete;
+    SharedNamedMatrix &operator=(SharedNamedMatrix &&) = delete;
+
+    ~SharedNamedMatrix() {
+        writer.cancel();
+        jit_object_unregister(matrix);
+        jit_object_free(matrix);
+    }
+
+    // Points the matrix at a free slot. False if readers have pinned every slot; the matrix then points at the
+    // scratch buffer and the frame written into it won't be published.
+    bool begin_frame() {
+        auto data = writer.begin_frame(frame_bytes(info));
+        framing = data != nullptr;
+        if (!framing) {
+            scratch.resize(frame_bytes(info));
+            data = scratch.data();
+        }
+        jit_object_method(matrix, _jit_sym_data, data);
+        return framing;
+    }
+
+    [[nodiscard]] bool has_slot() const {
+        return framing;
+    }
+
+    // Makes the frame written since begin_frame() visible to readers and claims a slot for the next one.
+    // JIT_ERR_DATA_UNAVAILABLE means this frame went to the scratch buffer and was dropped; whether the next
+    // frame got a slot is has_slot().
+    t_jit_err publish() {
+        if (!framing) {
+            begin_frame();
+            return JIT_ERR_DATA_UNAVAILABLE;
+        }
+        maxutils::trace_scope span{"shm publish", "matrix"};
+        jit_object_method(matrix, _jit_sym_getinfo, &info);
+        maxutils::shm::matrix_info shared{};
+        std::strncpy(shared.type, info.type->s_name, sizeof(shared.type) - 1);
+        shared.planecount = static_cast<int32_t>(info.planecount);
+        shared.dimcount = static_cast<int32_t>(info.dimcount);
+        for (long i = 0; i < info.dimcount; ++i) {
+            shared.dim[i] = info.dim[i];
+            shared.dimstride[i] = info.dimstride[i];
+        }
+        shared.size = frame_bytes(info);
+        writer.publish(shared);
+        begin_frame();
+        return JIT_ERR_NONE;
+    }
+
+    // Copies src into the current slot, following its type, planecount and dims, and publishes it.
+    t_jit_err publish(t_object *src) {
+        if (!framing && !begin_frame()) {
+            return JIT_ERR_DATA_UNAVAILABLE;
+        }
+        t_jit_matrix_info src_info;
+        jit_object_method(src, _jit_sym_getinfo, &src_info);
+        if (src_info.type != info.type || src_info.planecount != info.planecount
+            || src_info.dimcount != info.dimcount
+            || !std::equal(src_info.dim, src_info.dim + src_info.dimcount, info.dim)) {
+            auto err = set_info(src_info);
+            if (err) {
+                return err;
+            }
+        }
+        auto err = (t_jit_err) jit_object_method(matrix, _jit_sym_frommatrix, src, nullptr);
+        if (err) {
+            return err;
+        }
+        return publish();
+    }
+
+    t_jit_err set_info(const t_jit_matrix_info &next) {
+        info.type = next.type;
+        info.planecount = next.planecount;
+        info.dimcount = next.dimcount;
+        std::copy_n(next.dim, next.dimcount, info.dim);
+        writer.cancel();
+        framing = false;
+        auto err = (t_jit_err) jit_object_method(matrix, _jit_sym_setinfo_ex, &info);
+        if (err) {
+            return err;
+        }
+        // the writer grows the segment if the new frame doesn't fit
+        return begin_frame() ? JIT_ERR_NONE : JIT_ERR_DATA_UNAVAILABLE;
+    }
+
+    uint64_t last_sequence() const {
+        return writer.last_sequence();
+    }
+
+    t_jit_object *matrix;
+    t_atom name;
+
+private:
+    static uint64_t frame_bytes(const t_jit_matrix_info &info) {
+        uint64_t bytes = info.planecount * maxutils::shm::type_size(info.type->s_name);
+        for (long i = 0; i < info.dimcount; ++i) {
+            bytes *= info.dim[i];
+        }
+        return bytes;
+    }
+
+    t_jit_matrix_info info;
+    maxutils::shm_frame_writer writer;
+    std::vector<unsigned char> scratch;
+    bool framing = false;
+};
+
+#endif //SHARED_NAMED_MATRIX_HPP
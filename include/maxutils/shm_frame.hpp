@@ -0,0 +1,416 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef SHM_FRAME_HPP
+#define SHM_FRAME_HPP
+
+// Frames shared between processes through POSIX shared memory. This header doesn't depend on the Max SDK so
+// the other side (an analysis process, a test harness) can include it on its own; SharedNamedMatrix in
+// shared_named_matrix.hpp is the Max-side writer.
+//
+// The segment holds a header and a few slots, each a slot header (sequence, reader count, matrix info) and
+// the frame data. One writer fills a slot nobody is reading and publishes it by storing its sequence;
+// readers pin the newest slot while they read it in place. Neither side ever blocks the other: the writer
+// skips a frame if every slot is pinned, and a reader that loses a race just retries.
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace maxutils {
+    namespace shm {
+        constexpr uint32_t magic = 0x5246584d; // "MXFR"
+        constexpr uint32_t version = 1;
+        constexpr uint32_t max_dimcount = 32;
+        constexpr uint64_t writing = ~uint64_t{0};
+
+        static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+                      "Shared memory atomics must be lock-free to be address-free");
+
+        // t_jit_matrix_info with fixed-width fields, so both sides agree on the layout without the Max SDK.
+        struct matrix_info {
+            char type[16]; // "char", "long", "float32" or "float64"
+            int32_t planecount;
+            int32_t dimcount;
+            int64_t dim[max_dimcount];
+            int64_t dimstride[max_dimcount];
+            int64_t size;
+        };
+
+        struct alignas(64) segment_header {
+            // stored last, once everything else is in place, so a reader never sees a half-built header
+            std::atomic<uint32_t> magic;
+            uint32_t version;
+            uint32_t slot_count;
+            int32_t writer_pid;
+            uint64_t slot_capacity;
+            // (sequence << 16) | slot of the newest frame, 0 before the first
+            std::atomic<uint64_t> latest;
+            // set when the writer replaces the segment with a bigger one; readers reopen it by name
+            std::atomic<uint32_t> stale;
+        };
+
+        struct alignas(64) slot_header {
+            // sequence of the frame held, 0 if none, `writing` while the writer owns it
+            std::atomic<uint64_t> sequence;
+            std::atomic<uint32_t> readers;
+            matrix_info info;
+        };
+
+        constexpr size_t align(size_t n, size_t to = 64) {
+            return (n + to - 1) / to * to;
+        }
+
+        constexpr size_t slot_stride(uint64_t capacity) {
+            return align(sizeof(slot_header)) + align(capacity);
+        }
+
+        constexpr size_t segment_size(uint32_t slots, uint64_t capacity) {
+            return align(sizeof(segment_header)) + slots * slot_stride(capacity);
+        }
+
+        inline size_t type_size(const char *type) {
+            if (std::strcmp(type, "char") == 0) {
+                return 1;
+            }
+            return std::strcmp(type, "float64") == 0 ? 8 : 4;
+        }
+    }
+
+    // A mapped shared memory object. The creator unlinks the name when it goes away. Names start with a slash
+    // and, on macOS, are at most 31 characters.
+    class shm_segment {
+    public:
+        // Throws std::system_error with EEXIST if the name is already taken.
+        static std::shared_ptr<shm_segment> create(const std::string &name, size_t size) {
+            const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+            if (fd < 0) {
+                throw std::system_error(errno, std::generic_category(), "shm_open " + name);
+            }
+            if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+                const int err = errno;
+                close(fd);
+                shm_unlink(name.c_str());
+                throw std::system_error(err, std::generic_category(), "ftruncate " + name);
+            }
+            return map(name, fd, size, true);
+        }
+
+        // nullptr if there is no segment by that name (yet)
+        static std::shared_ptr<shm_segment> open(const std::string &name) {
+            const int fd = shm_open(name.c_str(), O_RDWR, 0600);
+            if (fd < 0) {
+                return nullptr;
+            }
+            struct stat st{};
+            if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(shm::segment_header)) {
+                close(fd);
+                return nullptr;
+            }
+            return map(name, fd, static_cast<size_t>(st.st_size), false);
+        }
+
+        shm_segment(const shm_segment &) = delete;
+        shm_segment &operator=(const shm_segment &) = delete;
+
+        ~shm_segment() {
+            munmap(base, length);
+            if (owner) {
+                shm_unlink(name.c_str());
+            }
+        }
+
+        [[nodiscard]] shm::segment_header *header() const {
+            return static_cast<shm::segment_header *>(base);
+        }
+
+        [[nodiscard]] shm::slot_header *slot(uint32_t i) const {
+            return reinterpret_cast<shm::slot_header *>(static_cast<unsigned char *>(base)
+                                                         + shm::align(sizeof(shm::segment_header))
+                                                         + i * shm::slot_stride(header()->slot_capacity));
+        }
+
+        [[nodiscard]] unsigned char *slot_data(uint32_t i) const {
+            return reinterpret_cast<unsigned char *>(slot(i)) + shm::align(sizeof(shm::slot_header));
+        }
+
+        [[nodiscard]] size_t size() const {
+            return length;
+        }
+
+        // Keeps the name when this goes away, e.g. once it has been replaced by a newer segment.
+        void disown() {
+            owner = false;
+        }
+
+    private:
+        shm_segment(std::string name, void *base, size_t length, bool owner)
+            : name{std::move(name)}, base{base}, length{length}, owner{owner} {
+        }
+
+        static std::shared_ptr<shm_segment> map(const std::string &name, int fd, size_t size, bool owner) {
+            void *p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            const int err = errno;
+            close(fd);
+            if (p == MAP_FAILED) {
+                if (owner) {
+                    shm_unlink(name.c_str());
+                }
+                throw std::system_error(err, std::generic_category(), "mmap " + name);
+            }
+            return std::shared_ptr<shm_segment>(new shm_segment{name, p, size, owner});
+        }
+
+        std::string name;
+        void *base;
+        size_t length;
+        bool owner;
+    };
+
+    // A published frame, pinned so the writer won't reuse its slot until this goes away. The data is read in
+    // place, so release frames promptly: while pinned the slot is out of the writer's rotation.
+    class shm_frame {
+    public:
+        shm_frame(const shm_frame &) = delete;
+        shm_frame &operator=(const shm_frame &) = delete;
+
+        shm_frame(shm_frame &&other) noexcept
+            : segment{std::move(other.segment)}, index{other.index}, seq{other.seq} {
+        }
+
+        shm_frame &operator=(shm_frame &&other) noexcept {
+            if (this != &other) {
+                release();
+                segment = std::move(other.segment);
+                index = other.index;
+                seq = other.seq;
+            }
+            return *this;
+        }
+
+        ~shm_frame() {
+            release();
+        }
+
+        [[nodiscard]] const shm::matrix_info &info() const {
+            return segment->slot(index)->info;
+        }
+
+        [[nodiscard]] const unsigned char *data() const {
+            return segment->slot_data(index);
+        }
+
+        [[nodiscard]] uint64_t sequence() const {
+            return seq;
+        }
+
+    private:
+        friend class shm_frame_reader;
+
+        shm_frame(std::shared_ptr<shm_segment> segment, uint32_t index, uint64_t seq)
+            : segment{std::move(segment)}, index{index}, seq{seq} {
+        }
+
+        void release() {
+            if (segment) {
+                segment->slot(index)->readers.fetch_sub(1, std::memory_order_release);
+                segment.reset();
+            }
+        }
+
+        std::shared_ptr<shm_segment> segment;
+        uint32_t index;
+        uint64_t seq;
+    };
+
+    class shm_frame_reader {
+    public:
+        // Doesn't need the writer to exist yet; acquire() connects when it appears.
+        explicit shm_frame_reader(std::string name) : name{std::move(name)} {
+            reconnect();
+        }
+
+        [[nodiscard]] bool connected() const {
+            return segment != nullptr;
+        }
+
+        bool reconnect() {
+            segment = shm_segment::open(name);
+            if (segment && (segment->header()->magic.load(std::memory_order_acquire) != shm::magic
+                            || segment->header()->version != shm::version
+                            || segment->size() < shm::segment_size(segment->header()->slot_count,
+                                                                   segment->header()->slot_capacity))) {
+                segment.reset();
+            }
+            return connected();
+        }
+
+        // Pins the newest frame if its sequence is greater than `after`.
+        std::optional<shm_frame> acquire(uint64_t after = 0) {
+            if ((!segment || segment->header()->stale.load(std::memory_order_acquire)) && !reconnect()) {
+                return std::nullopt;
+            }
+            for (int attempt = 0; attempt < 4; ++attempt) {
+                const uint64_t latest = segment->header()->latest.load(std::memory_order_acquire);
+                const uint64_t seq = latest >> 16;
+                const auto index = static_cast<uint32_t>(latest & 0xffff);
+                if (latest == 0 || seq <= after || index >= segment->header()->slot_count) {
+                    return std::nullopt;
+                }
+                // pairs with the writer's exchange then readers check: one of the two sides sees the other
+                auto *slot = segment->slot(index);
+                slot->readers.fetch_add(1, std::memory_order_seq_cst);
+                if (slot->sequence.load(std::memory_order_seq_cst) == seq) {
+                    return shm_frame{segment, index, seq};
+                }
+                slot->readers.fetch_sub(1, std::memory_order_release);
+            }
+            return std::nullopt;
+        }
+
+    private:
+        std::string name;
+        std::shared_ptr<shm_segment> segment;
+    };
+
+    // Owns the segment's name: constructing a second writer for a name that a live writer holds throws
+    // std::system_error with EEXIST. A segment left behind by a writer that has died is taken over.
+    class shm_frame_writer {
+    public:
+        static constexpr uint32_t max_slots = 0xffff;
+
+        shm_frame_writer(std::string name, uint64_t capacity, uint32_t slots = 3)
+            : name{std::move(name)}, slot_count{std::clamp(slots, 2u, max_slots)} {
+            allocate(capacity);
+        }
+
+        [[nodiscard]] uint64_t capacity() const {
+            return segment->header()->slot_capacity;
+        }
+
+        // Claims a slot for the next frame, replacing the segment if it's smaller than `bytes`. nullptr if
+        // every slot but the newest is pinned by readers, in which case the frame should be skipped.
+        unsigned char *begin_frame(uint64_t bytes) {
+            cancel();
+            if (bytes > capacity()) {
+                allocate(bytes);
+            }
+            const uint64_t latest = segment->header()->latest.load(std::memory_order_relaxed);
+            for (uint32_t i = 0; i < slot_count; ++i) {
+                if (latest != 0 && i == (latest & 0xffff)) {
+                    continue;
+                }
+                auto *slot = segment->slot(i);
+                const uint64_t previous = slot->sequence.exchange(shm::writing, std::memory_order_seq_cst);
+                if (slot->readers.load(std::memory_order_seq_cst) == 0) {
+                    claimed = i;
+                    return segment->slot_data(i);
+                }
+                slot->sequence.store(previous, std::memory_order_release);
+            }
+            return nullptr;
+        }
+
+        // Publishes the claimed slot. info.size must be within the size passed to begin_frame.
+        bool publish(const shm::matrix_info &info) {
+            if (!claimed) {
+                return false;
+            }
+            auto *slot = segment->slot(*claimed);
+            slot->info = info;
+            const uint64_t seq = ++sequence;
+            slot->sequence.store(seq, std::memory_order_release);
+            segment->header()->latest.store(seq << 16 | *claimed, std::memory_order_release);
+            claimed.reset();
+            return true;
+        }
+
+        // Gives up the claimed slot without publishing.
+        void cancel() {
+            if (claimed) {
+                segment->slot(*claimed)->sequence.store(0, std::memory_order_release);
+                claimed.reset();
+            }
+        }
+
+        [[nodiscard]] uint64_t last_sequence() const {
+            return sequence;
+        }
+
+    private:
+        void allocate(uint64_t capacity) {
+            const size_t size = shm::segment_size(slot_count, capacity);
+            std::shared_ptr<shm_segment> next;
+            if (segment) {
+                // growing: the name is ours, so it moves to the new segment
+                segment->disown();
+                shm_unlink(name.c_str());
+                next = shm_segment::create(name, size);
+            } else {
+                next = claim(size);
+            }
+            auto *header = new(next->header()) shm::segment_header{};
+            header->version = shm::version;
+            header->slot_count = slot_count;
+            header->writer_pid = static_cast<int32_t>(getpid());
+            header->slot_capacity = capacity;
+            for (uint32_t i = 0; i < slot_count; ++i) {
+                new(next->slot(i)) shm::slot_header{};
+            }
+            header->magic.store(shm::magic, std::memory_order_release);
+            if (segment) {
+                segment->header()->stale.store(1, std::memory_order_release);
+            }
+            segment = std::move(next);
+        }
+
+        std::shared_ptr<shm_segment> claim(size_t size) const {
+            try {
+                return shm_segment::create(name, size);
+            } catch (const std::system_error &e) {
+                if (e.code().value() != EEXIST) {
+                    throw;
+                }
+            }
+            // the writer that created it crashed or was killed before it could unlink the name
+            if (auto old = shm_segment::open(name); old && !writer_alive(*old->header())) {
+                old.reset();
+                shm_unlink(name.c_str());
+                return shm_segment::create(name, size);
+            }
+            throw std::system_error(EEXIST, std::generic_category(), "shm_open " + name + ": in use by another writer");
+        }
+
+        // A header that isn't finished yet counts as alive: its writer may still be filling it in.
+        static bool writer_alive(const shm::segment_header &header) {
+            if (header.magic.load(std::memory_order_acquire) != shm::magic) {
+                return true;
+            }
+            return header.writer_pid > 0 && (kill(header.writer_pid, 0) == 0 || errno == EPERM);
+        }
+
+        std::string name;
+        uint32_t slot_count;
+        std::shared_ptr<shm_segment> segment;
+        std::optional<uint32_t> claimed;
+        uint64_t sequence = 0;
+    };
+}
+
+#endif //SHM_FRAME_HPP
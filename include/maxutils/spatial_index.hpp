@@ -0,0 +1,518 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef SPATIAL_INDEX_HPP
+#define SPATIAL_INDEX_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "c74_jitter.h"
+#include "jit_matrix_view.hpp"
+#include "tracer.hpp"
+#include "vec_math.hpp"
+#include "detail/parallel.hpp"
+
+namespace maxutils {
+    using namespace c74::max;
+
+    namespace detail {
+        inline float distance2(const vec3f &a, const vec3f &b) {
+            const float dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+            return dx * dx + dy * dy + dz * dz;
+        }
+
+        inline size_t point_rows(const jit_matrix_view &m) {
+            return m.dimcount() > 1 ? m.rows() : 1;
+        }
+
+        // Copies every point of a vec3f matrix, row by row, into one contiguous buffer (reusing its storage).
+        inline void gather_points(jit_matrix_view &m, std::vector<vec3f> &out) {
+            const size_t rows = point_rows(m), cols = m.cols();
+            out.resize(rows * cols);
+            parallel_for(0, rows, 1, [&](size_t begin, size_t end) {
+                for (size_t r = begin; r < end; ++r) {
+                    auto row = m.row<vec3f>(r);
+                    std::copy(row.begin(), row.end(), out.begin() + r * cols);
+                }
+            });
+        }
+
+        // The k nearest candidates seen so far, sorted by squared distance.
+        struct neighbour_list {
+            uint32_t *indices;
+            float *distances2;
+            size_t k;
+            float limit2;
+            size_t count = 0;
+
+            [[nodiscard]] float worst2() const {
+                return count < k ? limit2 : distances2[k - 1];
+            }
+
+            void offer(uint32_t index, float d2) {
+                if (d2 >= worst2()) {
+                    return;
+                }
+                size_t j = count < k ? count++ : k - 1;
+                for (; j > 0 && distances2[j - 1] > d2; --j) {
+                    distances2[j] = distances2[j - 1];
+                    indices[j] = indices[j - 1];
+                }
+                distances2[j] = d2;
+                indices[j] = index;
+            }
+        };
+    }
+
+    // Uniform grid over a point cloud, built with a counting sort of the points by cell. Best when points are
+    // spread fairly evenly and queries use a radius close to the cell size. Rebuilding reuses all storage.
+    class point_grid {
+    public:
+        static constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+
+        // cell_size <= 0 picks one from the point density on every build
+        explicit point_grid(float cell_size = 0.0f) : requested_cell{cell_size} {
+        }
+
+        void set_cell_size(float cell_size) {
+            requested_cell = cell_size;
+        }
+
+        void build(jit_matrix_view &points) {
+            detail::gather_points(points, pts);
+            index_points();
+        }
+
+        void build(std::span<const vec3f> points) {
+            pts.assign(points.begin(), points.end());
+            index_points();
+        }
+
+        [[nodiscard]] std::span<const vec3f> points() const {
+            return pts;
+        }
+
+        // fn(index, squared_distance) for every point within radius of p, in no particular order.
+        template <typename Fn>
+        void for_each_in_radius(const vec3f &p, float radius, Fn &&fn) const {
+            if (pts.empty()) {
+                return;
+            }
+            const float r2 = radius * radius;
+            long lo[3], hi[3];
+            for (int a = 0; a < 3; ++a) {
+                lo[a] = cell_coord(p[a] - radius, a);
+                hi[a] = cell_coord(p[a] + radius, a);
+            }
+            for (long z = lo[2]; z <= hi[2]; ++z) {
+                for (long y = lo[1]; y <= hi[1]; ++y) {
+                    for (long x = lo[0]; x <= hi[0]; ++x) {
+                        const size_t c = cell_index(x, y, z);
+                        for (uint32_t s = cell_start[c]; s < cell_start[c + 1]; ++s) {
+                            const uint32_t i = order[s];
+                            if (const float d2 = detail::distance2(p, pts[i]); d2 <= r2) {
+                                fn(i, d2);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        // Writes up to k nearest indices (and squared distances) closer than max_distance, nearest first,
+        // ignoring `skip`. Returns how many were found.
+        size_t knn(const vec3f &p, size_t k, uint32_t *indices, float *distances2,
+                   float max_distance = std::numeric_limits<float>::infinity(), uint32_t skip = none) const {
+            if (pts.empty() || k == 0) {
+                return 0;
+            }
+            detail::neighbour_list best{indices, distances2, k, max_distance * max_distance};
+            const long centre[3] = {cell_coord(p[0], 0), cell_coord(p[1], 1), cell_coord(p[2], 2)};
+            const long max_ring = std::max({dims[0], dims[1], dims[2]});
+            for (long ring = 0; ring <= max_ring; ++ring) {
+                visit_ring(centre, ring, [&](size_t c) {
+                    for (uint32_t s = cell_start[c]; s < cell_start[c + 1]; ++s) {
+                        const uint32_t i = order[s];
+                        if (i != skip) {
+                            best.offer(i, detail::distance2(p, pts[i]));
+                        }
+                    }
+                });
+                // every cell in a later ring is at least ring * cell away
+                const float reach = static_cast<float>(ring) * cell;
+                if (reach * reach >= best.worst2()) {
+                    break;
+                }
+            }
+            return best.count;
+        }
+
+    private:
+        void index_points() {
+            trace_scope span{"grid build", "spatial"};
+            const size_t n = pts.size();
+            if (n == 0) {
+                return;
+            }
+            auto [lo, hi] = bounding_box<3>(std::span<const vec3f>{pts});
+            origin = lo;
+            choose_cell_size(lo, hi, n);
+
+            const size_t cells = static_cast<size_t>(dims[0] * dims[1] * dims[2]);
+            cell_of.resize(n);
+            cell_start.assign(cells + 1, 0);
+            order.resize(n);
+            if (cursor_capacity < cells) {
+                cursor = std::make_unique<std::atomic<uint32_t>[]>(cells);
+                cursor_capacity = cells;
+            }
+            for (size_t c = 0; c < cells; ++c) {
+                cursor[c].store(0, std::memory_order_relaxed);
+            }
+
+            // counting sort: count per cell in parallel, prefix sum, then scatter in parallel
+            detail::parallel_for(0, n, 1 << 14, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    const auto &p = pts[i];
+                    const auto c = static_cast<uint32_t>(cell_index(cell_coord(p[0], 0), cell_coord(p[1], 1), cell_coord(p[2], 2)));
+                    cell_of[i] = c;
+                    cursor[c].fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+            uint32_t total = 0;
+            for (size_t c = 0; c < cells; ++c) {
+                cell_start[c] = total;
+                total += cursor[c].load(std::memory_order_relaxed);
+                cursor[c].store(cell_start[c], std::memory_order_relaxed);
+            }
+            cell_start[cells] = total;
+            detail::parallel_for(0, n, 1 << 14, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    order[cursor[cell_of[i]].fetch_add(1, std::memory_order_relaxed)] = static_cast<uint32_t>(i);
+                }
+            });
+        }
+
+        void choose_cell_size(const vec3f &lo, const vec3f &hi, size_t n) {
+            float extent[3];
+            for (int a = 0; a < 3; ++a) {
+                extent[a] = std::isfinite(hi[a] - lo[a]) ? hi[a] - lo[a] : 0.0f;
+            }
+            cell = requested_cell;
+            if (!(cell > 0.0f)) {
+                // about one point per cell, measured over the axes the cloud actually spans
+                const float largest = std::max({extent[0], extent[1], extent[2]});
+                float volume = 1.0f;
+                int spanned = 0;
+                for (float e: extent) {
+                    if (e > largest * 1e-3f) {
+                        volume *= e;
+                        ++spanned;
+                    }
+                }
+                cell = spanned ? std::pow(volume / static_cast<float>(n), 1.0f / static_cast<float>(spanned)) : 1.0f;
+            }
+            // keep the cell count in proportion to the point count
+            const double max_cells = std::max<double>(64.0, 2.0 * static_cast<double>(n));
+            for (;;) {
+                double total = 1.0;
+                for (int a = 0; a < 3; ++a) {
+                    dims[a] = static_cast<long>(extent[a] / cell) + 1;
+                    total *= static_cast<double>(dims[a]);
+                }
+                if (total <= max_cells) {
+                    break;
+                }
+                cell *= 1.25f;
+            }
+        }
+
+        [[nodiscard]] long cell_coord(float v, int axis) const {
+            const float c = (v - origin[axis]) / cell;
+            // also catches NaN
+            if (!(c >= 0.0f)) {
+                return 0;
+            }
+            return std::min(static_cast<long>(c), dims[axis] - 1);
+        }
+
+        [[nodiscard]] size_t cell_index(long x, long y, long z) const {
+            return static_cast<size_t>((z * dims[1] + y) * dims[0] + x);
+        }
+
+        // Calls fn(cell) for each cell whose Chebyshev distance from centre is exactly ring.
+        template <typename Fn>
+        void visit_ring(const long (&centre)[3], long ring, Fn &&fn) const {
+            long lo[3], hi[3];
+            for (int a = 0; a < 3; ++a) {
+                lo[a] = std::max(0l, centre[a] - ring);
+                hi[a] = std::min(dims[a] - 1, centre[a] + ring);
+            }
+            for (long z = lo[2]; z <= hi[2]; ++z) {
+                const bool z_edge = std::abs(z - centre[2]) == ring;
+                for (long y = lo[1]; y <= hi[1]; ++y) {
+                    const bool yz_edge = z_edge || std::abs(y - centre[1]) == ring;
+                    if (yz_edge) {
+                        for (long x = lo[0]; x <= hi[0]; ++x) {
+                            fn(cell_index(x, y, z));
+                        }
+                    } else {
+                        if (centre[0] - ring >= 0) {
+                            fn(cell_index(centre[0] - ring, y, z));
+                        }
+                        if (ring > 0 && centre[0] + ring < dims[0]) {
+                            fn(cell_index(centre[0] + ring, y, z));
+                        }
+                    }
+                }
+            }
+        }
+
+        float requested_cell;
+        float cell = 1.0f;
+        vec3f origin{};
+        long dims[3] = {1, 1, 1};
+        std::vector<vec3f> pts;
+        std::vector<uint32_t> cell_of;
+        std::vector<uint32_t> cell_start;
+        std::vector<uint32_t> order;
+        std::unique_ptr<std::atomic<uint32_t>[]> cursor;
+        size_t cursor_capacity = 0;
+    };
+
+    // Balanced k-d tree stored implicitly in a permuted copy of the points: the node for [lo, hi) keeps its
+    // splitting point at mid = (lo + hi) / 2. Copes with clustered or skewed clouds that defeat a uniform grid.
+    // Rebuilding reuses all storage; the lower levels are built in parallel.
+    class kd_tree {
+    public:
+        static constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+        static constexpr size_t leaf_size = 8;
+
+        void build(jit_matrix_view &points) {
+            detail::gather_points(points, pts);
+            index_points();
+        }
+
+        void build(std::span<const vec3f> points) {
+            pts.assign(points.begin(), points.end());
+            index_points();
+        }
+
+        [[nodiscard]] std::span<const vec3f> points() const {
+            return pts;
+        }
+
+        template <typename Fn>
+        void for_each_in_radius(const vec3f &p, float radius, Fn &&fn) const {
+            radius_range(0, nodes.size(), p, radius * radius, fn);
+        }
+
+        size_t knn(const vec3f &p, size_t k, uint32_t *indices, float *distances2,
+                   float max_distance = std::numeric_limits<float>::infinity(), uint32_t skip = none) const {
+            if (k == 0) {
+                return 0;
+            }
+            detail::neighbour_list best{indices, distances2, k, max_distance * max_distance};
+            knn_range(0, nodes.size(), p, best, skip);
+            return best.count;
+        }
+
+    private:
+        struct node {
+            vec3f p;
+            uint32_t index;
+        };
+
+        // a range of nodes and the box of space it covers
+        struct region {
+            size_t lo;
+            size_t hi;
+            vec3f min;
+            vec3f max;
+        };
+
+        void index_points() {
+            trace_scope span{"kd build", "spatial"};
+            const size_t n = pts.size();
+            nodes.resize(n);
+            split_axis.resize(n);
+            for (size_t i = 0; i < n; ++i) {
+                nodes[i] = {pts[i], static_cast<uint32_t>(i)};
+            }
+            auto [lo, hi] = bounding_box<3>(std::span<const vec3f>{pts});
+            // split the top levels here until there are enough independent subtrees to go round the pool
+            const size_t wanted = detail::thread_pool::get().concurrency() * 4;
+            pending.assign(1, {0, n, lo, hi});
+            while (pending.size() < wanted) {
+                next_pending.clear();
+                for (const auto &r: pending) {
+                    if (r.hi - r.lo > leaf_size) {
+                        auto [left, right] = split(r);
+                        next_pending.push_back(left);
+                        next_pending.push_back(right);
+                    }
+                }
+                if (next_pending.empty()) {
+                    pending.clear();
+                    break;
+                }
+                std::swap(pending, next_pending);
+            }
+            detail::parallel_for(0, pending.size(), 1, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    build_region(pending[i]);
+                }
+            });
+        }
+
+        void build_region(region r) {
+            while (r.hi - r.lo > leaf_size) {
+                auto [left, right] = split(r);
+                build_region(left);
+                r = right;
+            }
+        }
+
+        // Partitions the region around its median along the widest side of its box.
+        std::pair<region, region> split(const region &r) {
+            unsigned char axis = 0;
+            for (unsigned char a = 1; a < 3; ++a) {
+                if (r.max[a] - r.min[a] > r.max[axis] - r.min[axis]) {
+                    axis = a;
+                }
+            }
+            const size_t mid = r.lo + (r.hi - r.lo) / 2;
+            std::nth_element(nodes.begin() + r.lo, nodes.begin() + mid, nodes.begin() + r.hi,
+                             [axis](const node &a, const node &b) { return a.p[axis] < b.p[axis]; });
+            split_axis[mid] = axis;
+            region left = r, right = r;
+            left.hi = mid;
+            left.max[axis] = nodes[mid].p[axis];
+            right.lo = mid + 1;
+            right.min[axis] = nodes[mid].p[axis];
+            return {left, right};
+        }
+
+        template <typename Fn>
+        void radius_range(size_t lo, size_t hi, const vec3f &p, float r2, Fn &fn) const {
+            while (lo < hi) {
+                if (hi - lo <= leaf_size) {
+                    for (size_t s = lo; s < hi; ++s) {
+                        if (const float d2 = detail::distance2(p, nodes[s].p); d2 <= r2) {
+                            fn(nodes[s].index, d2);
+                        }
+                    }
+                    return;
+                }
+                const size_t mid = lo + (hi - lo) / 2;
+                const node &n = nodes[mid];
+                if (const float d2 = detail::distance2(p, n.p); d2 <= r2) {
+                    fn(n.index, d2);
+                }
+                const float diff = p[split_axis[mid]] - n.p[split_axis[mid]];
+                if (diff * diff <= r2) {
+                    if (diff < 0.0f) {
+                        radius_range(mid + 1, hi, p, r2, fn);
+                    } else {
+                        radius_range(lo, mid, p, r2, fn);
+                    }
+                }
+                if (diff < 0.0f) {
+                    hi = mid;
+                } else {
+                    lo = mid + 1;
+                }
+            }
+        }
+
+        void knn_range(size_t lo, size_t hi, const vec3f &p, detail::neighbour_list &best, uint32_t skip) const {
+            if (lo >= hi) {
+                return;
+            }
+            if (hi - lo <= leaf_size) {
+                for (size_t s = lo; s < hi; ++s) {
+                    if (nodes[s].index != skip) {
+                        best.offer(nodes[s].index, detail::distance2(p, nodes[s].p));
+                    }
+                }
+                return;
+            }
+            const size_t mid = lo + (hi - lo) / 2;
+            const node &n = nodes[mid];
+            if (n.index != skip) {
+                best.offer(n.index, detail::distance2(p, n.p));
+            }
+            const float diff = p[split_axis[mid]] - n.p[split_axis[mid]];
+            if (diff < 0.0f) {
+                knn_range(lo, mid, p, best, skip);
+                if (diff * diff < best.worst2()) {
+                    knn_range(mid + 1, hi, p, best, skip);
+                }
+            } else {
+                knn_range(mid + 1, hi, p, best, skip);
+                if (diff * diff < best.worst2()) {
+                    knn_range(lo, mid, p, best, skip);
+                }
+            }
+        }
+
+        std::vector<vec3f> pts;
+        std::vector<node> nodes;
+        std::vector<unsigned char> split_axis;
+        // top-level regions of the last build, kept so rebuilding doesn't allocate them again
+        std::vector<region> pending;
+        std::vector<region> next_pending;
+    };
+
+    // For every point of `queries` (a vec3f matrix), writes the indices of its nearest indexed points into the
+    // matching cell of `out`, a long matrix with the same dims whose planecount sets how many neighbours to
+    // find. Only neighbours closer than max_distance are written; unused planes get -1. Point indices count
+    // along rows, so the point at (x, y) is y * cols + x. With exclude_self, querying the indexed matrix
+    // itself skips each point's own index.
+    template <typename Index>
+    t_jit_err nearest_neighbours(const Index &index, jit_matrix_view &queries, jit_matrix_view &out,
+                                 float max_distance = std::numeric_limits<float>::infinity(), bool exclude_self = false) {
+        if (out.type() != _jit_sym_long || queries.type() != _jit_sym_float32) {
+            return JIT_ERR_MISMATCH_TYPE;
+        }
+        if (queries.planecount() != 3) {
+            return JIT_ERR_MISMATCH_PLANE;
+        }
+        if (out.cols() != queries.cols() || detail::point_rows(out) != detail::point_rows(queries)) {
+            return JIT_ERR_MISMATCH_DIM;
+        }
+        trace_scope span{"nearest neighbours", "spatial"};
+        const size_t k = out.planecount();
+        const size_t cols = queries.cols();
+        detail::parallel_for(0, detail::point_rows(queries), 1, [&](size_t begin, size_t end) {
+            // per-thread, so chunks (a row each) don't allocate
+            static thread_local std::vector<uint32_t> indices;
+            static thread_local std::vector<float> distances2;
+            indices.resize(k);
+            distances2.resize(k);
+            for (size_t r = begin; r < end; ++r) {
+                auto in = queries.row<vec3f>(r);
+                auto dst = out.plane_row<int32_t>(r);
+                for (size_t c = 0; c < cols; ++c) {
+                    const auto self = exclude_self ? static_cast<uint32_t>(r * cols + c) : Index::none;
+                    const size_t found = index.knn(in[c], k, indices.data(), distances2.data(), max_distance, self);
+                    for (size_t j = 0; j < k; ++j) {
+                        dst[c * k + j] = j < found ? static_cast<int32_t>(indices[j]) : -1;
+                    }
+                }
+            }
+        });
+        return JIT_ERR_NONE;
+    }
+}
+
+#endif //SPATIAL_INDEX_HPP
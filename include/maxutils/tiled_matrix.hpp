@@ -0,0 +1,175 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef TILED_MATRIX_HPP
+#define TILED_MATRIX_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "ext.h"
+#include "tracer.hpp"
+#include "detail/parallel.hpp"
+
+using namespace c74::max;
+
+namespace maxutils {
+    // Cell order inside each 16x16 tile of a TiledMatrix; the tiles themselves are stored row after row.
+    enum class tile_order {
+        row_major,
+        morton,
+    };
+
+    namespace detail {
+        constexpr long tile_bits = 4;
+        constexpr long tile_side = 1l << tile_bits;
+        constexpr long tile_cells = tile_side * tile_side;
+
+        // Spreads the low 4 bits of v to the even bits of a byte.
+        constexpr uint32_t spread4(uint32_t v) {
+            v = (v | (v << 2)) & 0x33;
+            return (v | (v << 1)) & 0x55;
+        }
+
+        constexpr uint32_t tile_index(tile_order order, uint32_t x, uint32_t y) {
+            return order == tile_order::morton ? spread4(x) | (spread4(y) << 1) : y * tile_side + x;
+        }
+
+        inline size_t jit_type_size(t_symbol *type) {
+            if (type == _jit_sym_char) {
+                return 1;
+            }
+            return type == _jit_sym_float64 ? 8 : 4;
+        }
+    }
+}
+
+// An internal matrix stored as 16x16-cell tiles, each either row-major or in Z (Morton) order, so that reads
+// with 2D locality (sampling, neighbourhood lookups, spatial hashing) touch a few cache lines instead of one
+// per row. It isn't a Jitter matrix: copy to and from one with to_matrix()/from_matrix(), which move whole tile
+// rows at a time. 1D or 2D; dims are padded up to whole tiles.
+class TiledMatrix {
+public:
+    TiledMatrix(t_symbol *type, std::vector<long> dims, long planecount,
+                maxutils::tile_order order = maxutils::tile_order::morton)
+        : type{type}, planecount{planecount}, order{order}, cell_bytes{maxutils::detail::jit_type_size(type) * planecount} {
+        if (set_dims(std::move(dims))) {
+            throw std::runtime_error("TiledMatrix is 1D or 2D");
+        }
+    }
+
+    explicit TiledMatrix(const t_jit_matrix_info *info, maxutils::tile_order order = maxutils::tile_order::morton)
+        : TiledMatrix(info->type, std::vector<long>(info->dim, info->dim + info->dimcount), info->planecount, order) {
+    }
+
+    t_jit_err set_dims(std::vector<long> dims) {
+        using namespace maxutils::detail;
+        if (dims.empty() || dims.size() > 2) return JIT_ERR_MISMATCH_DIM;
+        width = dims[0];
+        height = dims.size() > 1 ? dims[1] : 1;
+        dimcount = static_cast<long>(dims.size());
+        tiles_x = (width + tile_side - 1) / tile_side;
+        tiles_y = (height + tile_side - 1) / tile_side;
+        storage.assign(tiles_x * tiles_y * tile_cells * cell_bytes, 0);
+        // the offset of (x, y) is x_offsets[x] + y_offsets[y]: the x and y bits never mix in either order
+        x_offsets.resize(width);
+        for (long x = 0; x < width; ++x) {
+            x_offsets[x] = ((x >> tile_bits) * tile_cells + tile_index(order, x & (tile_side - 1), 0)) * cell_bytes;
+        }
+        y_offsets.resize(height);
+        for (long y = 0; y < height; ++y) {
+            y_offsets[y] = ((y >> tile_bits) * tiles_x * tile_cells + tile_index(order, 0, y & (tile_side - 1))) * cell_bytes;
+        }
+        return JIT_ERR_NONE;
+    }
+
+    // First plane of cell (x, y); the cell's other planes follow it.
+    template <typename T>
+    T &at(long x, long y = 0) {
+        return *reinterpret_cast<T *>(storage.data() + offset(x, y));
+    }
+
+    [[nodiscard]] size_t offset(long x, long y) const {
+        return x_offsets[x] + y_offsets[y];
+    }
+
+    void clear() {
+        std::fill(storage.begin(), storage.end(), 0);
+    }
+
+    // Copies into a Jitter matrix of the same type, planecount and dims.
+    t_jit_err to_matrix(void *matrix) {
+        return transfer(matrix, true);
+    }
+
+    t_jit_err from_matrix(void *matrix) {
+        return transfer(matrix, false);
+    }
+
+    [[nodiscard]] long dim(long i) const {
+        return i == 0 ? width : height;
+    }
+
+    [[nodiscard]] maxutils::tile_order get_order() const {
+        return order;
+    }
+
+private:
+    // Row-major <-> tiled a tile row at a time, so each tile is written (or read) while it's in cache.
+    t_jit_err transfer(void *matrix, bool to_rows) {
+        using namespace maxutils::detail;
+        if (!matrix) return JIT_ERR_INVALID_PTR;
+        t_jit_matrix_info info;
+        jit_object_method(matrix, _jit_sym_getinfo, &info);
+        if (info.type != type) return JIT_ERR_MISMATCH_TYPE;
+        if (info.planecount != planecount) return JIT_ERR_MISMATCH_PLANE;
+        if (info.dimcount != dimcount || info.dim[0] != width || (dimcount > 1 && info.dim[1] != height)) {
+            return JIT_ERR_MISMATCH_DIM;
+        }
+        unsigned char *data = nullptr;
+        jit_object_method(matrix, _jit_sym_getdata, &data);
+        if (!data) return JIT_ERR_INVALID_PTR;
+        maxutils::trace_scope span{to_rows ? "untile" : "tile", "matrix"};
+
+        const long row_stride = dimcount > 1 ? info.dimstride[1] : 0;
+        // Morton order keeps horizontally adjacent pairs of cells together; row-major order whole tile rows
+        const long run = order == maxutils::tile_order::morton ? 2 : tile_side;
+        maxutils::detail::parallel_for(0, tiles_y, 1, [&](size_t begin, size_t end) {
+            for (long ty = static_cast<long>(begin); ty < static_cast<long>(end); ++ty) {
+                const long y1 = std::min(height, (ty + 1) * tile_side);
+                for (long y = ty * tile_side; y < y1; ++y) {
+                    unsigned char *row = data + y * row_stride;
+                    for (long x = 0; x < width; x += run) {
+                        const size_t bytes = std::min(run, width - x) * cell_bytes;
+                        unsigned char *cell = storage.data() + offset(x, y);
+                        if (to_rows) {
+                            std::memcpy(row + x * cell_bytes, cell, bytes);
+                        } else {
+                            std::memcpy(cell, row + x * cell_bytes, bytes);
+                        }
+                    }
+                }
+            }
+        });
+        return JIT_ERR_NONE;
+    }
+
+    t_symbol *type;
+    long planecount;
+    maxutils::tile_order order;
+    size_t cell_bytes;
+    long dimcount = 0;
+    long width = 0;
+    long height = 0;
+    long tiles_x = 0;
+    long tiles_y = 0;
+    std::vector<unsigned char> storage;
+    std::vector<size_t> x_offsets;
+    std::vector<size_t> y_offsets;
+};
+
+#endif //TILED_MATRIX_HPP
@@ -0,0 +1,194 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef TRACER_HPP
+#define TRACER_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+#include "ext.h"
+#include "detail/clock.hpp"
+
+namespace maxutils {
+    using namespace c74::max;
+
+    // Process-wide, opt-in recorder of timed spans that can be dumped as Chrome trace-event JSON
+    // (chrome://tracing, ui.perfetto.dev). Spans go into a buffer allocated by start(); once it is full
+    // further spans are dropped rather than allocating on the hot path. start() waits for spans being
+    // recorded to finish before it reuses or replaces the buffer.
+    // start(), stop() and dump() are meant to be called from the main thread.
+    class tracer {
+    public:
+        static constexpr size_t max_threads = 256;
+
+        static tracer &get() {
+            static tracer instance;
+            return instance;
+        }
+
+        [[nodiscard]] static bool enabled() {
+            return get().recording.load(std::memory_order_acquire);
+        }
+
+        void start(size_t capacity = 1 << 16) {
+            recording.store(false, std::memory_order_seq_cst);
+            // record() registers as a writer before it checks recording, so once the count drops to zero no
+            // writer can be touching the buffer and none can start until recording is set again
+            while (writers.load(std::memory_order_seq_cst) != 0) {
+                std::this_thread::yield();
+            }
+            if (capacity > this->capacity.load(std::memory_order_relaxed)) {
+                events = std::make_unique<event[]>(capacity);
+                this->capacity.store(capacity, std::memory_order_relaxed);
+            }
+            for (size_t i = 0; i < this->capacity.load(std::memory_order_relaxed); ++i) {
+                events[i].committed.store(false, std::memory_order_relaxed);
+            }
+            next.store(0, std::memory_order_relaxed);
+            dropped.store(0, std::memory_order_relaxed);
+            origin_ns = detail::now_ns();
+            recording.store(true, std::memory_order_seq_cst);
+        }
+
+        void stop() {
+            recording.store(false, std::memory_order_release);
+        }
+
+        // name and category must outlive the tracer, in practice they are string literals. Spans that began
+        // before the current start() are dropped.
+        void record(const char *name, const char *category, uint64_t start_ns, uint64_t end_ns) {
+            writers.fetch_add(1, std::memory_order_seq_cst);
+            if (recording.load(std::memory_order_seq_cst) && start_ns >= origin_ns) {
+                const size_t index = next.fetch_add(1, std::memory_order_relaxed);
+                if (index < capacity.load(std::memory_order_relaxed)) {
+                    event &e = events[index];
+                    e.name = name;
+                    e.category = category;
+                    e.start_ns = start_ns;
+                    e.duration_ns = end_ns - start_ns;
+                    e.tid = thread_id();
+                    e.committed.store(true, std::memory_order_release);
+                } else {
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            writers.fetch_sub(1, std::memory_order_release);
+        }
+
+        void set_thread_name(const char *name) {
+            const uint32_t tid = thread_id();
+            if (tid < max_threads) {
+                thread_names[tid].store(name, std::memory_order_relaxed);
+            }
+        }
+
+        [[nodiscard]] size_t dropped_count() const {
+            return dropped.load(std::memory_order_relaxed);
+        }
+
+        t_max_err dump(const char *path) const {
+            FILE *file = std::fopen(path, "w");
+            if (!file) {
+                return MAX_ERR_GENERIC;
+            }
+            std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+            bool first = true;
+            for (size_t tid = 0; tid < max_threads; ++tid) {
+                if (const char *name = thread_names[tid].load(std::memory_order_relaxed)) {
+                    std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"args\":{\"name\":",
+                                 first ? "" : ",\n", tid);
+                    write_string(file, name);
+                    std::fputs("}}", file);
+                    first = false;
+                }
+            }
+            const size_t count = std::min(next.load(std::memory_order_relaxed), capacity.load(std::memory_order_relaxed));
+            for (size_t i = 0; i < count; ++i) {
+                const event &e = events[i];
+                if (!e.committed.load(std::memory_order_acquire)) {
+                    continue;
+                }
+                const double ts = static_cast<double>(e.start_ns - origin_ns) / 1000.0;
+                std::fprintf(file, "%s{\"name\":", first ? "" : ",\n");
+                write_string(file, e.name);
+                std::fputs(",\"cat\":", file);
+                write_string(file, e.category);
+                std::fprintf(file, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                             ts, static_cast<double>(e.duration_ns) / 1000.0, e.tid);
+                first = false;
+            }
+            std::fputs("\n]}\n", file);
+            return std::fclose(file) == 0 ? MAX_ERR_NONE : MAX_ERR_GENERIC;
+        }
+
+    private:
+        struct event {
+            const char *name;
+            const char *category;
+            uint64_t start_ns;
+            uint64_t duration_ns;
+            uint32_t tid;
+            std::atomic<bool> committed;
+        };
+
+        tracer() = default;
+
+        static uint32_t thread_id() {
+            static std::atomic<uint32_t> next_tid{0};
+            static thread_local const uint32_t tid = next_tid.fetch_add(1, std::memory_order_relaxed);
+            return tid;
+        }
+
+        static void write_string(FILE *file, const char *s) {
+            std::fputc('"', file);
+            for (; *s; ++s) {
+                if (*s == '"' || *s == '\\') {
+                    std::fputc('\\', file);
+                }
+                std::fputc(*s, file);
+            }
+            std::fputc('"', file);
+        }
+
+        std::unique_ptr<event[]> events;
+        std::atomic<size_t> capacity{0};
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> writers{0};
+        std::atomic<size_t> dropped{0};
+        std::atomic<bool> recording{false};
+        uint64_t origin_ns = 0;
+        std::array<std::atomic<const char *>, max_threads> thread_names{};
+    };
+
+    // Records a span from construction to destruction while the tracer is running, and costs a single
+    // atomic load when it isn't.
+    class trace_scope {
+    public:
+        explicit trace_scope(const char *name, const char *category = "maxutils")
+            : name{name}, category{category}, start_ns{tracer::enabled() ? detail::now_ns() : 0} {
+        }
+
+        ~trace_scope() {
+            if (start_ns && tracer::enabled()) {
+                tracer::get().record(name, category, start_ns, detail::now_ns());
+            }
+        }
+
+        trace_scope(const trace_scope &) = delete;
+        trace_scope &operator=(const trace_scope &) = delete;
+
+    private:
+        const char *name;
+        const char *category;
+        uint64_t start_ns;
+    };
+}
+
+#endif //TRACER_HPP
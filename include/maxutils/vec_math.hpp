@@ -0,0 +1,280 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef VEC_MATH_HPP
+#define VEC_MATH_HPP
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <span>
+#include <utility>
+
+#include "jit_matrix_view.hpp"
+#include "tracer.hpp"
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+
+namespace maxutils {
+    // Column-major 4x4 matrix, as OpenGL and jit.gl use: element (row, col) is m[col * 4 + row].
+    using mat4f = std::array<float, 16>;
+
+    // Batched operations over spans of vec2f / vec3f / vec4f. Points are loaded four at a time and
+    // transposed into one register per component (AoS -> SoA), so every instruction works on four points;
+    // leftovers at the end of a span go through the same maths one point at a time.
+    // Spans longer than vec_math::grain are split across the maxutils thread pool. Output spans may alias inputs.
+    // N is given explicitly, e.g. transform<3>(points, points, m).
+    namespace vec_math {
+        inline constexpr size_t grain = 1 << 14;
+    }
+
+    namespace detail {
+        template <size_t N>
+        using vecf = vec_<float, N>;
+
+        template <size_t N>
+        void load_soa(const vecf<N> *p, f32x4 (&out)[N]) {
+            load_deinterleaved<N>(reinterpret_cast<const float *>(p), out);
+        }
+
+        template <size_t N>
+        void store_aos(vecf<N> *p, const f32x4 (&in)[N]) {
+            store_interleaved<N>(reinterpret_cast<float *>(p), in);
+        }
+
+        // Runs block(i) for every group of four points and single(i) for the rest, in parallel chunks.
+        template <typename Block, typename Single>
+        void for_each_batch(size_t count, Block &&block, Single &&single) {
+            parallel_for(0, (count + 3) / 4, vec_math::grain / 4, [&](size_t begin, size_t end) {
+                for (size_t b = begin; b < end; ++b) {
+                    const size_t i = b * 4;
+                    if (i + 4 <= count) {
+                        block(i);
+                    } else {
+                        for (size_t j = i; j < count; ++j) {
+                            single(j);
+                        }
+                    }
+                }
+            });
+        }
+    }
+
+    // out[i] = m * (in[i], 0.., 1). vec2f/vec3f use the affine part of m, vec4f the whole matrix.
+    template <size_t N>
+    void transform(std::span<const vec_<float, N>> in, std::span<vec_<float, N>> out, const mat4f &m) {
+        assert(out.size() >= in.size());
+        trace_scope span{"vec transform", "vec_math"};
+        detail::for_each_batch(in.size(), [&](size_t i) {
+            detail::f32x4 c[N], r[N];
+            detail::load_soa<N>(in.data() + i, c);
+            for (size_t row = 0; row < N; ++row) {
+                auto acc = detail::f32x4::set1(N < 4 ? m[12 + row] : 0.0f);
+                for (size_t col = 0; col < N; ++col) {
+                    acc = fma(acc, detail::f32x4::set1(m[col * 4 + row]), c[col]);
+                }
+                r[row] = acc;
+            }
+            detail::store_aos<N>(out.data() + i, r);
+        }, [&](size_t i) {
+            const auto p = in[i];
+            for (size_t row = 0; row < N; ++row) {
+                float acc = N < 4 ? m[12 + row] : 0.0f;
+                for (size_t col = 0; col < N; ++col) {
+                    acc += m[col * 4 + row] * p[col];
+                }
+                out[i][row] = acc;
+            }
+        });
+    }
+
+    // Scales every vector to unit length; zero vectors stay zero.
+    template <size_t N>
+    void normalize(std::span<const vec_<float, N>> in, std::span<vec_<float, N>> out) {
+        assert(out.size() >= in.size());
+        trace_scope span{"vec normalize", "vec_math"};
+        constexpr float tiny = std::numeric_limits<float>::min();
+        detail::for_each_batch(in.size(), [&](size_t i) {
+            detail::f32x4 c[N];
+            detail::load_soa<N>(in.data() + i, c);
+            auto len2 = detail::f32x4::zero();
+            for (size_t k = 0; k < N; ++k) {
+                len2 = fma(len2, c[k], c[k]);
+            }
+            const auto inv = detail::f32x4::set1(1.0f) / max(sqrt(len2), detail::f32x4::set1(tiny));
+            for (size_t k = 0; k < N; ++k) {
+                c[k] = c[k] * inv;
+            }
+            detail::store_aos<N>(out.data() + i, c);
+        }, [&](size_t i) {
+            const auto p = in[i];
+            float len2 = 0.0f;
+            for (size_t k = 0; k < N; ++k) {
+                len2 += p[k] * p[k];
+            }
+            const float inv = 1.0f / std::max(std::sqrt(len2), tiny);
+            for (size_t k = 0; k < N; ++k) {
+                out[i][k] = p[k] * inv;
+            }
+        });
+    }
+
+    // out[i] = dot(a[i], b[i])
+    template <size_t N>
+    void dot(std::span<const vec_<float, N>> a, std::span<const vec_<float, N>> b, std::span<float> out) {
+        assert(b.size() >= a.size() && out.size() >= a.size());
+        trace_scope span{"vec dot", "vec_math"};
+        detail::for_each_batch(a.size(), [&](size_t i) {
+            detail::f32x4 ca[N], cb[N];
+            detail::load_soa<N>(a.data() + i, ca);
+            detail::load_soa<N>(b.data() + i, cb);
+            auto acc = detail::f32x4::zero();
+            for (size_t k = 0; k < N; ++k) {
+                acc = fma(acc, ca[k], cb[k]);
+            }
+            acc.store(out.data() + i);
+        }, [&](size_t i) {
+            float acc = 0.0f;
+            for (size_t k = 0; k < N; ++k) {
+                acc += a[i][k] * b[i][k];
+            }
+            out[i] = acc;
+        });
+    }
+
+    // out[i] = cross(a[i], b[i])
+    inline void cross(std::span<const vec3f> a, std::span<const vec3f> b, std::span<vec3f> out) {
+        assert(b.size() >= a.size() && out.size() >= a.size());
+        trace_scope span{"vec cross", "vec_math"};
+        detail::for_each_batch(a.size(), [&](size_t i) {
+            detail::f32x4 ca[3], cb[3], r[3];
+            detail::load_soa<3>(a.data() + i, ca);
+            detail::load_soa<3>(b.data() + i, cb);
+            r[0] = ca[1] * cb[2] - ca[2] * cb[1];
+            r[1] = ca[2] * cb[0] - ca[0] * cb[2];
+            r[2] = ca[0] * cb[1] - ca[1] * cb[0];
+            detail::store_aos<3>(out.data() + i, r);
+        }, [&](size_t i) {
+            const auto p = a[i], q = b[i];
+            out[i] = {p[1] * q[2] - p[2] * q[1], p[2] * q[0] - p[0] * q[2], p[0] * q[1] - p[1] * q[0]};
+        });
+    }
+
+    // out[i] = |points[i] - point|
+    template <size_t N>
+    void distance_to(std::span<const vec_<float, N>> points, const vec_<float, N> &point, std::span<float> out) {
+        assert(out.size() >= points.size());
+        trace_scope span{"vec distance", "vec_math"};
+        detail::f32x4 target[N];
+        for (size_t k = 0; k < N; ++k) {
+            target[k] = detail::f32x4::set1(point[k]);
+        }
+        detail::for_each_batch(points.size(), [&](size_t i) {
+            detail::f32x4 c[N];
+            detail::load_soa<N>(points.data() + i, c);
+            auto acc = detail::f32x4::zero();
+            for (size_t k = 0; k < N; ++k) {
+                const auto d = c[k] - target[k];
+                acc = fma(acc, d, d);
+            }
+            sqrt(acc).store(out.data() + i);
+        }, [&](size_t i) {
+            float acc = 0.0f;
+            for (size_t k = 0; k < N; ++k) {
+                const float d = points[i][k] - point[k];
+                acc += d * d;
+            }
+            out[i] = std::sqrt(acc);
+        });
+    }
+
+    // Component-wise {min, max} over all points. An empty span gives {+inf, -inf}.
+    template <size_t N>
+    std::pair<vec_<float, N>, vec_<float, N>> bounding_box(std::span<const vec_<float, N>> points) {
+        trace_scope span{"vec bounding box", "vec_math"};
+        constexpr float inf = std::numeric_limits<float>::infinity();
+        vec_<float, N> lo, hi;
+        for (size_t k = 0; k < N; ++k) {
+            lo[k] = inf;
+            hi[k] = -inf;
+        }
+        std::mutex merge_mutex;
+        detail::parallel_for(0, points.size(), vec_math::grain, [&](size_t begin, size_t end) {
+            detail::f32x4 vlo[N], vhi[N];
+            for (size_t k = 0; k < N; ++k) {
+                vlo[k] = detail::f32x4::set1(inf);
+                vhi[k] = detail::f32x4::set1(-inf);
+            }
+            size_t i = begin;
+            for (; i + 4 <= end; i += 4) {
+                detail::f32x4 c[N];
+                detail::load_soa<N>(points.data() + i, c);
+                for (size_t k = 0; k < N; ++k) {
+                    vlo[k] = min(vlo[k], c[k]);
+                    vhi[k] = max(vhi[k], c[k]);
+                }
+            }
+            vec_<float, N> chunk_lo, chunk_hi;
+            for (size_t k = 0; k < N; ++k) {
+                float l[4], h[4];
+                vlo[k].store(l);
+                vhi[k].store(h);
+                chunk_lo[k] = std::min({l[0], l[1], l[2], l[3]});
+                chunk_hi[k] = std::max({h[0], h[1], h[2], h[3]});
+            }
+            for (; i < end; ++i) {
+                for (size_t k = 0; k < N; ++k) {
+                    chunk_lo[k] = std::min(chunk_lo[k], points[i][k]);
+                    chunk_hi[k] = std::max(chunk_hi[k], points[i][k]);
+                }
+            }
+            std::lock_guard lock{merge_mutex};
+            for (size_t k = 0; k < N; ++k) {
+                lo[k] = std::min(lo[k], chunk_lo[k]);
+                hi[k] = std::max(hi[k], chunk_hi[k]);
+            }
+        });
+        return {lo, hi};
+    }
+
+    // Whole-matrix versions for point clouds stored as N-plane float32 matrices, one row per task.
+    template <size_t N>
+    void transform(jit_matrix_view &in, jit_matrix_view &out, const mat4f &m) {
+        detail::parallel_for(0, in.rows(), 1, [&](size_t begin, size_t end) {
+            for (size_t r = begin; r < end; ++r) {
+                transform<N>(in.row<vec_<float, N>>(r), out.row<vec_<float, N>>(r), m);
+            }
+        });
+    }
+
+    template <size_t N>
+    void normalize(jit_matrix_view &in, jit_matrix_view &out) {
+        detail::parallel_for(0, in.rows(), 1, [&](size_t begin, size_t end) {
+            for (size_t r = begin; r < end; ++r) {
+                normalize<N>(in.row<vec_<float, N>>(r), out.row<vec_<float, N>>(r));
+            }
+        });
+    }
+
+    template <size_t N>
+    std::pair<vec_<float, N>, vec_<float, N>> bounding_box(jit_matrix_view &points) {
+        if (points.rows() == 0) {
+            return bounding_box<N>(std::span<const vec_<float, N>>{});
+        }
+        auto [lo, hi] = bounding_box<N>(std::span<const vec_<float, N>>{points.row<vec_<float, N>>(0)});
+        for (size_t r = 1; r < points.rows(); ++r) {
+            auto [row_lo, row_hi] = bounding_box<N>(std::span<const vec_<float, N>>{points.row<vec_<float, N>>(r)});
+            for (size_t k = 0; k < N; ++k) {
+                lo[k] = std::min(lo[k], row_lo[k]);
+                hi[k] = std::max(hi[k], row_hi[k]);
+            }
+        }
+        return {lo, hi};
+    }
+}
+
+#endif //VEC_MATH_HPP
@@ -0,0 +1,111 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#ifndef VISIT_MATRIX_HPP
+#define VISIT_MATRIX_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "c74_jitter.h"
+#include "jit_matrix_view_v2.hpp"
+
+namespace maxutils {
+    using namespace c74::max;
+
+    template <typename... Ts>
+    struct type_list {
+    };
+
+    using all_matrix_types = type_list<char, int32_t, float, double>;
+
+    // Planecount 1-4 as a compile-time constant; visitors get a plain long for anything else.
+    template <long N>
+    using planecount_c = std::integral_constant<long, N>;
+
+    namespace detail {
+        template <size_t, typename T>
+        using repeat_t = T;
+
+        template <typename F, typename... Args>
+        t_jit_err invoke_visitor(F &fn, Args &&... args) {
+            if constexpr (std::is_void_v<std::invoke_result_t<F &, Args...>>) {
+                std::invoke(fn, std::forward<Args>(args)...);
+                return JIT_ERR_NONE;
+            } else {
+                return std::invoke(fn, std::forward<Args>(args)...);
+            }
+        }
+
+        template <typename F, typename Views, size_t... I>
+        t_jit_err visit_planes(F &fn, Views &views, long planecount, std::index_sequence<I...>) {
+            switch (planecount) {
+                case 1: return invoke_visitor(fn, std::get<I>(views)..., planecount_c<1>{});
+                case 2: return invoke_visitor(fn, std::get<I>(views)..., planecount_c<2>{});
+                case 3: return invoke_visitor(fn, std::get<I>(views)..., planecount_c<3>{});
+                case 4: return invoke_visitor(fn, std::get<I>(views)..., planecount_c<4>{});
+                default: return invoke_visitor(fn, std::get<I>(views)..., planecount);
+            }
+        }
+
+        template <typename T, typename F, size_t K, size_t... I>
+        t_jit_err visit_typed(F &fn, void *const (&matrices)[K], const t_jit_matrix_info (&infos)[K],
+                              std::index_sequence<I...> seq) {
+            // only building the views is guarded: exceptions thrown by fn are the caller's to handle
+            std::optional<std::tuple<repeat_t<I, matrix_view<T>>...>> views;
+            try {
+                views.emplace(matrix_view<T>{static_cast<t_object *>(matrices[I]), infos[I]}...);
+            } catch (const std::exception &) {
+                return JIT_ERR_INVALID_PTR;
+            }
+            const bool shared = std::all_of(infos, infos + K, [&](const t_jit_matrix_info &info) {
+                return info.planecount == infos[0].planecount;
+            });
+            return visit_planes(fn, *views, shared ? infos[0].planecount : -1, seq);
+        }
+    }
+
+    // Reads each matrix's info once and calls fn(matrix_view<T> &..., planes) with views of the matrices' type,
+    // which they must all share. planes is a planecount_c<N> when every matrix has the same planecount N in
+    // 1-4, so `for (long p = 0; p < planes; ++p)` unrolls, and a long otherwise (the shared planecount, or -1
+    // if they differ). Only the types in Types are instantiated. fn returns t_jit_err or nothing.
+    //
+    //     visit_matrices({in_matrix, out_matrix}, [](auto &in, auto &out, auto planes) { ... });
+    template <typename Types = all_matrix_types, size_t K, typename F>
+    t_jit_err visit_matrices(void *const (&matrices)[K], F &&fn) {
+        static_assert(K > 0);
+        t_jit_matrix_info infos[K];
+        for (size_t i = 0; i < K; ++i) {
+            if (!matrices[i]) {
+                return JIT_ERR_INVALID_PTR;
+            }
+            jit_object_method(matrices[i], _jit_sym_getinfo, &infos[i]);
+            if (infos[i].type != infos[0].type) {
+                return JIT_ERR_MISMATCH_TYPE;
+            }
+        }
+        return [&]<typename... Ts>(type_list<Ts...>) {
+            t_jit_err err = JIT_ERR_MISMATCH_TYPE;
+            ((infos[0].type == type_sym<Ts>()
+                  ? (err = detail::visit_typed<Ts>(fn, matrices, infos, std::make_index_sequence<K>{}), true)
+                  : false) || ...);
+            return err;
+        }(Types{});
+    }
+
+    // Single-matrix form: fn(matrix_view<T> &, planes).
+    template <typename Types = all_matrix_types, typename F>
+    t_jit_err visit_matrix(void *matrix, F &&fn) {
+        void *const matrices[1] = {matrix};
+        return visit_matrices<Types>(matrices, std::forward<F>(fn));
+    }
+}
+
+#endif //VISIT_MATRIX_HPP
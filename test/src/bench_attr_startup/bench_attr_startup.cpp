@@ -0,0 +1,308 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#include <chrono>
+#include "ext.h"
+#include "maxutils/attributes.hpp"
+#include "maxutils/attr_table.hpp"
+
+using namespace c74::max;
+
+struct t_bench_attr_startup {
+    t_object ob;
+    enum class Mode { off, low, mid, high };
+    bool bool_attr_0;
+    long long_attr_0;
+    float float_attr_0;
+    Mode enum_attr_0;
+    bool bool_attr_1;
+    long long_attr_1;
+    float float_attr_1;
+    Mode enum_attr_1;
+    bool bool_attr_2;
+    long long_attr_2;
+    float float_attr_2;
+    Mode enum_attr_2;
+    bool bool_attr_3;
+    long long_attr_3;
+    float float_attr_3;
+    Mode enum_attr_3;
+    bool bool_attr_4;
+    long long_attr_4;
+    float float_attr_4;
+    Mode enum_attr_4;
+    bool bool_attr_5;
+    long long_attr_5;
+    float float_attr_5;
+    Mode enum_attr_5;
+    bool bool_attr_6;
+    long long_attr_6;
+    float float_attr_6;
+    Mode enum_attr_6;
+    bool bool_attr_7;
+    long long_attr_7;
+    float float_attr_7;
+    Mode enum_attr_7;
+    bool bool_attr_8;
+    long long_attr_8;
+    float float_attr_8;
+    Mode enum_attr_8;
+    bool bool_attr_9;
+    long long_attr_9;
+    float float_attr_9;
+    Mode enum_attr_9;
+    bool bool_attr_10;
+    long long_attr_10;
+    float float_attr_10;
+    Mode enum_attr_10;
+    bool bool_attr_11;
+    long long_attr_11;
+    float float_attr_11;
+    Mode enum_attr_11;
+    bool bool_attr_12;
+    long long_attr_12;
+    float float_attr_12;
+    Mode enum_attr_12;
+    bool bool_attr_13;
+    long long_attr_13;
+    float float_attr_13;
+    Mode enum_attr_13;
+    bool bool_attr_14;
+    long long_attr_14;
+    float float_attr_14;
+    Mode enum_attr_14;
+    bool bool_attr_15;
+    long long_attr_15;
+    float float_attr_15;
+    Mode enum_attr_15;
+    bool bool_attr_16;
+    long long_attr_16;
+    float float_attr_16;
+    Mode enum_attr_16;
+    bool bool_attr_17;
+    long long_attr_17;
+    float float_attr_17;
+    Mode enum_attr_17;
+    bool bool_attr_18;
+    long long_attr_18;
+    float float_attr_18;
+    Mode enum_attr_18;
+    bool bool_attr_19;
+    long long_attr_19;
+    float float_attr_19;
+    Mode enum_attr_19;
+};
+
+using bench_attrs = maxutils::attrs<
+        &t_bench_attr_startup::bool_attr_0,
+        &t_bench_attr_startup::long_attr_0,
+        &t_bench_attr_startup::float_attr_0,
+        &t_bench_attr_startup::enum_attr_0,
+        &t_bench_attr_startup::bool_attr_1,
+        &t_bench_attr_startup::long_attr_1,
+        &t_bench_attr_startup::float_attr_1,
+        &t_bench_attr_startup::enum_attr_1,
+        &t_bench_attr_startup::bool_attr_2,
+        &t_bench_attr_startup::long_attr_2,
+        &t_bench_attr_startup::float_attr_2,
+        &t_bench_attr_startup::enum_attr_2,
+        &t_bench_attr_startup::bool_attr_3,
+        &t_bench_attr_startup::long_attr_3,
+        &t_bench_attr_startup::float_attr_3,
+        &t_bench_attr_startup::enum_attr_3,
+        &t_bench_attr_startup::bool_attr_4,
+        &t_bench_attr_startup::long_attr_4,
+        &t_bench_attr_startup::float_attr_4,
+        &t_bench_attr_startup::enum_attr_4,
+        &t_bench_attr_startup::bool_attr_5,
+        &t_bench_attr_startup::long_attr_5,
+        &t_bench_attr_startup::float_attr_5,
+        &t_bench_attr_startup::enum_attr_5,
+        &t_bench_attr_startup::bool_attr_6,
+        &t_bench_attr_startup::long_attr_6,
+        &t_bench_attr_startup::float_attr_6,
+        &t_bench_attr_startup::enum_attr_6,
+        &t_bench_attr_startup::bool_attr_7,
+        &t_bench_attr_startup::long_attr_7,
+        &t_bench_attr_startup::float_attr_7,
+        &t_bench_attr_startup::enum_attr_7,
+        &t_bench_attr_startup::bool_attr_8,
+        &t_bench_attr_startup::long_attr_8,
+        &t_bench_attr_startup::float_attr_8,
+        &t_bench_attr_startup::enum_attr_8,
+        &t_bench_attr_startup::bool_attr_9,
+        &t_bench_attr_startup::long_attr_9,
+        &t_bench_attr_startup::float_attr_9,
+        &t_bench_attr_startup::enum_attr_9,
+        &t_bench_attr_startup::bool_attr_10,
+        &t_bench_attr_startup::long_attr_10,
+        &t_bench_attr_startup::float_attr_10,
+        &t_bench_attr_startup::enum_attr_10,
+        &t_bench_attr_startup::bool_attr_11,
+        &t_bench_attr_startup::long_attr_11,
+        &t_bench_attr_startup::float_attr_11,
+        &t_bench_attr_startup::enum_attr_11,
+        &t_bench_attr_startup::bool_attr_12,
+        &t_bench_attr_startup::long_attr_12,
+        &t_bench_attr_startup::float_attr_12,
+        &t_bench_attr_startup::enum_attr_12,
+        &t_bench_attr_startup::bool_attr_13,
+        &t_bench_attr_startup::long_attr_13,
+        &t_bench_attr_startup::float_attr_13,
+        &t_bench_attr_startup::enum_attr_13,
+        &t_bench_attr_startup::bool_attr_14,
+        &t_bench_attr_startup::long_attr_14,
+        &t_bench_attr_startup::float_attr_14,
+        &t_bench_attr_startup::enum_attr_14,
+        &t_bench_attr_startup::bool_attr_15,
+        &t_bench_attr_startup::long_attr_15,
+        &t_bench_attr_startup::float_attr_15,
+        &t_bench_attr_startup::enum_attr_15,
+        &t_bench_attr_startup::bool_attr_16,
+        &t_bench_attr_startup::long_attr_16,
+        &t_bench_attr_startup::float_attr_16,
+        &t_bench_attr_startup::enum_attr_16,
+        &t_bench_attr_startup::bool_attr_17,
+        &t_bench_attr_startup::long_attr_17,
+        &t_bench_attr_startup::float_attr_17,
+        &t_bench_attr_startup::enum_attr_17,
+        &t_bench_attr_startup::bool_attr_18,
+        &t_bench_attr_startup::long_attr_18,
+        &t_bench_attr_startup::float_attr_18,
+        &t_bench_attr_startup::enum_attr_18,
+        &t_bench_attr_startup::bool_attr_19,
+        &t_bench_attr_startup::long_attr_19,
+        &t_bench_attr_startup::float_attr_19,
+        &t_bench_attr_startup::enum_attr_19
+>;
+
+static t_class *c;
+static constexpr int iterations = 50;
+
+BEGIN_USING_C_LINKAGE
+
+t_bench_attr_startup *bench_attr_startup_new(t_symbol *s, long argc, t_atom *argv);
+void bench_attr_startup_free(t_bench_attr_startup *x);
+
+END_USING_C_LINKAGE
+
+static void register_with_builders(t_class *c) {
+    maxutils::create_attr<&t_bench_attr_startup::bool_attr_0>(c);
+    maxutils::create_attr<&t_bench_attr_startup::long_attr_0>(c);
+    maxutils::create_attr<&t_bench_attr_startup::float_attr_0>(c);
+    maxutils::create_attr<&t_bench_attr_startup::enum_attr_0>(c);
+    maxutils::create_attr<&t_bench_attr_startup::bool_attr_1>(c);
+    maxutils::create_attr<&t_bench_attr_startup::long_attr_1>(c);
+    maxutils::create_attr<&t_bench_attr_startup::float_attr_1>(c);
+    maxutils::create_attr<&t_bench_attr_startup::enum_attr_1>(c);
+    maxutils::create_attr<&t_bench_attr_startup::bool_attr_2>(c);
+    maxutils::create_attr<&t_bench_attr_startup::long_attr_2>(c);
+    maxutils::create_attr<&t_bench_attr_startup::float_attr_2>(c);
+    maxutils::create_attr<&t_bench_attr_startup::enum_attr_2>(c);
+    maxutils::create_attr<&t_bench_attr_startup::bool_attr_3>(c);
+    maxutils::create_attr<&t_bench_attr_startup::long_attr_3>(c);
+    maxutils::create_attr<&t_bench_attr_startup::float_attr_3>(c);
+    maxutils::create_attr<&t_bench_attr_startup::enum_attr_3>(c);
+    maxutils::create_attr<&t_bench_attr_startup::bool_attr_4>(c);
+    maxutils::create_attr<&t_bench_attr_startup::long_attr_4>(c);
+    maxutils::create_attr<&t_bench_attr_startup::float_attr_4>(c);
+    maxutils::create_attr<&t_bench_attr_startup::enum_attr_4>(c);
+    maxutils::create_attr<&t_bench_attr_startup::bool_attr_5>(c);
+    maxutils::create_attr<&t_bench_attr_startup::long_attr_5>(c);
+    maxutils::create_attr<&t_bench_attr_startup::float_attr_5>(c);
+    maxutils::create_attr<&t_bench_attr_startup::enum_attr_5>(c);
+    maxutils::create_attr<&t_bench_attr_startup::bool_attr_6>(c);
+    maxutils::create_attr<&t_bench_attr_startup::long_attr_6>(c);
+    maxutils::create_attr<&t_bench_attr_startup::float_attr_6>(c);
+    maxutils::create_attr<&t_bench_attr_startup::enum_attr_6>(c);
+    maxutils::create_attr<&t_bench_attr_startup::bool_attr_7>(c);
+    maxutils::create_attr<&t_bench_attr_startup::long_attr_7>(c);
+    maxutils::create_attr<&t_bench_attr_startup::float_attr_7>(c);
+    maxutils::create_attr<&t_bench_attr_startup::enum_attr_7>(c);
+    maxutils::create_attr<&t_bench_attr_startup::bool_attr_8>(c);
+    maxutils::create_attr<&t_bench_attr_startup::long_attr_8>(c);
+    maxutils::create_attr<&t_bench_attr_startup::float_attr_8>(c);
+    maxutils::create_attr<&t_bench_attr_startup::enum_attr_8>(c);
+    maxutils::create_attr<&t_bench_attr_startup::bool_attr_9>(c);
+    maxutils::create_attr<&t_bench_attr_startup::long_attr_9>(c);
+    maxutils::create_attr<&t_bench_attr_startup::float_attr_9>(c);
+    maxutils::create_attr<&t_bench_attr_startup::enum_attr_9>(c);
+    maxutils::create_attr<&t_bench_attr_startup::bool_attr_10>(c);
+    maxutils::create_attr<&t_bench_attr_startup::long_attr_10>(c);
+    maxutils::create_attr<&t_bench_attr_startup::float_attr_10>(c);
+    maxutils::create_attr<&t_bench_attr_startup::enum_attr_10>(c);
+    maxutils::create_attr<&t_bench_attr_startup::bool_attr_11>(c);
+    maxutils::create_attr<&t_bench_attr_startup::long_attr_11>(c);
+    maxutils::create_attr<&t_bench_attr_startup::float_attr_11>(c);
+    maxutils::create_attr<&t_bench_attr_startup::enum_attr_11>(c);
+    maxutils::create_attr<&t_bench_attr_startup::bool_attr_12>(c);
+    maxutils::create_attr<&t_bench_attr_startup::long_attr_12>(c);
+    maxutils::create_attr<&t_bench_attr_startup::float_attr_12>(c);
+    maxutils::create_attr<&t_bench_attr_startup::enum_attr_12>(c);
+    maxutils::create_attr<&t_bench_attr_startup::bool_attr_13>(c);
+    maxutils::create_attr<&t_bench_attr_startup::long_attr_13>(c);
+    maxutils::create_attr<&t_bench_attr_startup::float_attr_13>(c);
+    maxutils::create_attr<&t_bench_attr_startup::enum_attr_13>(c);
+    maxutils::create_attr<&t_bench_attr_startup::bool_attr_14>(c);
+    maxutils::create_attr<&t_bench_attr_startup::long_attr_14>(c);
+    maxutils::create_attr<&t_bench_attr_startup::float_attr_14>(c);
+    maxutils::create_attr<&t_bench_attr_startup::enum_attr_14>(c);
+    maxutils::create_attr<&t_bench_attr_startup::bool_attr_15>(c);
+    maxutils::create_attr<&t_bench_attr_startup::long_attr_15>(c);
+    maxutils::create_attr<&t_bench_attr_startup::float_attr_15>(c);
+    maxutils::create_attr<&t_bench_attr_startup::enum_attr_15>(c);
+    maxutils::create_attr<&t_bench_attr_startup::bool_attr_16>(c);
+    maxutils::create_attr<&t_bench_attr_startup::long_attr_16>(c);
+    maxutils::create_attr<&t_bench_attr_startup::float_attr_16>(c);
+    maxutils::create_attr<&t_bench_attr_startup::enum_attr_16>(c);
+    maxutils::create_attr<&t_bench_attr_startup::bool_attr_17>(c);
+    maxutils::create_attr<&t_bench_attr_startup::long_attr_17>(c);
+    maxutils::create_attr<&t_bench_attr_startup::float_attr_17>(c);
+    maxutils::create_attr<&t_bench_attr_startup::enum_attr_17>(c);
+    maxutils::create_attr<&t_bench_attr_startup::bool_attr_18>(c);
+    maxutils::create_attr<&t_bench_attr_startup::long_attr_18>(c);
+    maxutils::create_attr<&t_bench_attr_startup::float_attr_18>(c);
+    maxutils::create_attr<&t_bench_attr_startup::enum_attr_18>(c);
+    maxutils::create_attr<&t_bench_attr_startup::bool_attr_19>(c);
+    maxutils::create_attr<&t_bench_attr_startup::long_attr_19>(c);
+    maxutils::create_attr<&t_bench_attr_startup::float_attr_19>(c);
+    maxutils::create_attr<&t_bench_attr_startup::enum_attr_19>(c);
+}
+
+template <typename Register>
+static double time_registration(const char *name, Register &&register_attrs) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        t_class *tmp = class_new(name, (method) bench_attr_startup_new, (method) bench_attr_startup_free,
+                                 sizeof(t_bench_attr_startup), nullptr, A_GIMME, 0);
+        register_attrs(tmp);
+        class_free(tmp);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+
+BEGIN_USING_C_LINKAGE
+
+void ext_main(void *) {
+    const double builders_us = time_registration("bench_attr_startup_builders", register_with_builders);
+    const double table_us = time_registration("bench_attr_startup_table", bench_attrs::register_all);
+    post("bench_attr_startup: %d attributes, create_attr %.1f us, attrs<> %.1f us per class",
+         80, builders_us, table_us);
+
+    c = class_new("bench_attr_startup", (method) bench_attr_startup_new, (method) bench_attr_startup_free,
+                  sizeof(t_bench_attr_startup), nullptr, A_GIMME, 0);
+    bench_attrs::register_all(c);
+    class_register(CLASS_BOX, c);
+}
+
+END_USING_C_LINKAGE
+
+t_bench_attr_startup *bench_attr_startup_new(t_symbol *s, long argc, t_atom *argv) {
+    auto *x = (t_bench_attr_startup *) object_alloc(c);
+    return x;
+}
+
+void bench_attr_startup_free(t_bench_attr_startup *x) {
+}
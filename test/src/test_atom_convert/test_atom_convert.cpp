@@ -0,0 +1,133 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+#include "ext.h"
+#include "maxutils/atom_convert.hpp"
+#include "maxutils/named_matrix.hpp"
+
+using namespace c74::max;
+
+struct t_test_atom_convert {
+    t_object ob;
+    t_outlet *outlet;
+};
+
+static t_class *c;
+
+BEGIN_USING_C_LINKAGE
+
+t_test_atom_convert *test_atom_convert_new(t_symbol *s, long argc, t_atom *argv);
+void test_atom_convert_free(t_test_atom_convert *x);
+void test_atom_convert_bang(t_test_atom_convert *x);
+
+void ext_main(void *) {
+    c = class_new("test_atom_convert", (method)test_atom_convert_new, (method)test_atom_convert_free,
+                  sizeof(t_test_atom_convert), nullptr, A_GIMME, 0);
+    class_addmethod(c, (method)test_atom_convert_bang, "bang", 0);
+    class_register(CLASS_BOX, c);
+}
+
+END_USING_C_LINKAGE
+
+t_test_atom_convert *test_atom_convert_new(t_symbol *s, long argc, t_atom *argv) {
+    auto *x = (t_test_atom_convert *)object_alloc(c);
+    x->outlet = outlet_new(x, nullptr);
+    return x;
+}
+
+void test_atom_convert_free(t_test_atom_convert *x) {
+    outlet_delete(x->outlet);
+}
+
+// Round trips homogeneous float and long lists and a mixed list with a symbol in it through 3x2 matrices,
+// checks that longs outside a cell's range saturate rather than wrap, and that a short list leaves the
+// remaining cells alone. Outputs 1 if everything passes.
+void test_atom_convert_bang(t_test_atom_convert *x) {
+    bool ok = true;
+    const auto check = [&](bool condition, const char *what) {
+        if (!condition) {
+            object_error((t_object *)x, "failed: %s", what);
+            ok = false;
+        }
+    };
+    maxutils::atom_arena arena;
+
+    NamedMatrix floats{_jit_sym_float32, {3, 2}, 1};
+    maxutils::matrix_view<float> float_view{(t_object *)floats.matrix};
+    std::array<t_atom, 6> float_list;
+    for (size_t i = 0; i < float_list.size(); ++i) {
+        atom_setfloat(&float_list[i], 0.5 * static_cast<double>(i) - 1.0);
+    }
+    check(maxutils::from_atoms(std::span<const t_atom>{float_list}, float_view) == 6, "float list not fully read");
+    auto out = maxutils::to_atoms(float_view, arena);
+    bool floats_match = out.size() == 6;
+    for (size_t i = 0; floats_match && i < out.size(); ++i) {
+        floats_match = atom_gettype(&out[i]) == A_FLOAT && atom_getfloat(&out[i]) == atom_getfloat(&float_list[i]);
+    }
+    check(floats_match, "float list doesn't round trip");
+
+    NamedMatrix longs{_jit_sym_long, {3, 2}, 1};
+    maxutils::matrix_view<int32_t> long_view{(t_object *)longs.matrix};
+    constexpr auto int32_max = std::numeric_limits<int32_t>::max();
+    constexpr auto int32_min = std::numeric_limits<int32_t>::min();
+    const std::array<t_atom_long, 6> long_values{0, -7, 123456, int32_max, int32_min, 42};
+    std::array<t_atom, 6> long_list;
+    for (size_t i = 0; i < long_list.size(); ++i) {
+        atom_setlong(&long_list[i], long_values[i]);
+    }
+    check(maxutils::from_atoms(std::span<const t_atom>{long_list}, long_view) == 6, "long list not fully read");
+    out = maxutils::to_atoms(long_view, arena);
+    bool longs_match = out.size() == 6;
+    for (size_t i = 0; longs_match && i < out.size(); ++i) {
+        longs_match = atom_gettype(&out[i]) == A_LONG && atom_getlong(&out[i]) == long_values[i];
+    }
+    check(longs_match, "long list doesn't round trip");
+
+    // 3000000000 and friends don't fit a long cell and must clamp, not wrap
+    const std::array<t_atom_long, 4> out_of_range{3000000000ll, -3000000000ll, 1ll << 40, -(1ll << 40)};
+    std::array<t_atom, 4> range_list;
+    for (size_t i = 0; i < range_list.size(); ++i) {
+        atom_setlong(&range_list[i], out_of_range[i]);
+    }
+    maxutils::from_atoms(std::span<const t_atom>{range_list}, long_view);
+    check(long_view.at(0, 0)[0] == int32_max && long_view.at(1, 0)[0] == int32_min
+          && long_view.at(2, 0)[0] == int32_max && long_view.at(0, 1)[0] == int32_min,
+          "out of range longs don't saturate in a long matrix");
+    // the two cells past the end of the list keep their values
+    check(long_view.at(1, 1)[0] == int32_min && long_view.at(2, 1)[0] == 42, "short list overwrote cells");
+
+    NamedMatrix chars{_jit_sym_char, {3, 2}, 1};
+    maxutils::matrix_view<char> char_view{(t_object *)chars.matrix};
+    maxutils::from_atoms(std::span<const t_atom>{range_list}, char_view);
+    check(static_cast<unsigned char>(char_view.at(0, 0)[0]) == 255 && char_view.at(1, 0)[0] == 0,
+          "out of range longs don't saturate in a char matrix");
+
+    // symbols, and anything else that isn't a number, read as 0
+    std::array<t_atom, 6> mixed;
+    atom_setlong(&mixed[0], 3);
+    atom_setfloat(&mixed[1], 2.6);
+    atom_setsym(&mixed[2], gensym("foo"));
+    atom_setlong(&mixed[3], -3000000000ll);
+    atom_setfloat(&mixed[4], -1.5);
+    atom_setlong(&mixed[5], 9);
+    maxutils::from_atoms(std::span<const t_atom>{mixed}, long_view);
+    out = maxutils::to_atoms(long_view, arena);
+    const std::array<t_atom_long, 6> mixed_longs{3, 3, 0, int32_min, -2, 9};
+    bool mixed_match = out.size() == 6;
+    for (size_t i = 0; mixed_match && i < out.size(); ++i) {
+        mixed_match = atom_getlong(&out[i]) == mixed_longs[i];
+    }
+    check(mixed_match, "mixed list doesn't convert as expected into a long matrix");
+    maxutils::from_atoms(std::span<const t_atom>{mixed}, float_view);
+    check(float_view.at(0, 0)[0] == 3.0f && float_view.at(1, 0)[0] == 2.6f && float_view.at(2, 0)[0] == 0.0f
+          && float_view.at(0, 1)[0] == -3.0e9f && float_view.at(1, 1)[0] == -1.5f && float_view.at(2, 1)[0] == 9.0f,
+          "mixed list doesn't convert as expected into a float matrix");
+
+    outlet_int(x->outlet, ok);
+}
@@ -2,6 +2,8 @@
 // Created by Obi Davis on 12/06/2024.
 //
 
+#include <cmath>
+
 #include "ext.h"
 #include "maxutils/attr.hpp"
 #include "maxutils/attributes.hpp"
@@ -26,6 +28,7 @@ BEGIN_USING_C_LINKAGE
 
 t_test_attr *test_attr_new(t_symbol *s, long argc, t_atom *argv);
 void test_attr_free(t_test_attr *x);
+void test_attr_bang(t_test_attr *x);
 
 void ext_main(void *) {
     c = class_new("test_attr", (method)test_attr_new, (method)test_attr_free, sizeof(t_test_attr), nullptr, A_GIMME, 0);
@@ -33,11 +36,14 @@ void ext_main(void *) {
 
     maxutils::create_attr<&t_test_attr::boolean_attr>(c);
     maxutils::create_attr<&t_test_attr::char_attr>(c);
-    maxutils::create_attr<&t_test_attr::long_attr>(c);
+    maxutils::create_attr<&t_test_attr::long_attr>(c).satisfying_predicate([](long v) { return v >= 0; },
+                                                                            "long_attr must be non-negative");
     maxutils::create_attr<&t_test_attr::float_attr>(c);
     maxutils::create_attr<&t_test_attr::double_attr>(c);
     maxutils::create_attr<&t_test_attr::enum_attr>(c);
     // maxutils::create_attr<&t_test_attr::symbol_attr>(c);
+
+    class_addmethod(c, (method)test_attr_bang, "bang", 0);
 }
 
 END_USING_C_LINKAGE
@@ -50,4 +56,61 @@ t_test_attr *test_attr_new(t_symbol *s, long argc, t_atom *argv) {
 
 void test_attr_free(t_test_attr *x) {
     outlet_delete(x->outlet);
-}
\ No newline at end of file
+}
+
+static void set_values(t_test_attr *x, bool b, char ch, long l, float f, double d, t_test_attr::Enum e) {
+    x->boolean_attr = b;
+    x->char_attr = ch;
+    x->long_attr = l;
+    x->float_attr = f;
+    x->double_attr = d;
+    x->enum_attr = e;
+}
+
+static bool same_values(const t_test_attr *a, const t_test_attr *b) {
+    return a->boolean_attr == b->boolean_attr && a->char_attr == b->char_attr && a->long_attr == b->long_attr
+        && a->float_attr == b->float_attr && a->double_attr == b->double_attr && a->enum_attr == b->enum_attr;
+}
+
+// Runs the attribute schema checks and outputs 1 if they all pass.
+void test_attr_bang(t_test_attr *x) {
+    auto &schema = maxutils::attr_schema<t_test_attr>::get();
+    bool ok = true;
+    const auto check = [&](bool condition, const char *what) {
+        if (!condition) {
+            object_error((t_object *)x, "failed: %s", what);
+            ok = false;
+        }
+    };
+
+    t_test_attr saved{};
+    set_values(&saved, true, 12, 10, 0.25f, 2.0, t_test_attr::Enum::B);
+    set_values(x, true, 12, 10, 0.25f, 2.0, t_test_attr::Enum::B);
+    const auto a = schema.snapshot(x);
+    set_values(x, false, 0, 20, 0.75f, 4.0, t_test_attr::Enum::C);
+    const auto b = schema.snapshot(x);
+
+    check(schema.restore(x, a) == MAX_ERR_NONE && same_values(x, &saved), "restore round trip");
+
+    check(schema.interpolate(x, a, b, 0.25) == MAX_ERR_NONE, "interpolate");
+    check(x->long_attr == 13 && std::abs(x->float_attr - 0.375f) < 1e-6f && x->double_attr == 2.5, "interpolate blends numbers");
+    check(x->boolean_attr && x->enum_attr == t_test_attr::Enum::B, "interpolate steps before half way");
+    check(schema.interpolate(x, a, b, 0.75) == MAX_ERR_NONE && !x->boolean_attr
+          && x->enum_attr == t_test_attr::Enum::C, "interpolate steps after half way");
+
+    schema.restore(x, a);
+    auto mismatched = b;
+    reinterpret_cast<maxutils::detail::attr_snapshot_header *>(mismatched.data())->schema_hash ^= 1;
+    check(schema.restore(x, mismatched) != MAX_ERR_NONE && same_values(x, &saved), "schema hash mismatch is rejected");
+    check(schema.interpolate(x, a, mismatched, 0.5) != MAX_ERR_NONE && same_values(x, &saved),
+          "schema hash mismatch is rejected when interpolating");
+    check(schema.restore(x, std::span(b).first(b.size() - 1)) != MAX_ERR_NONE && same_values(x, &saved),
+          "short snapshot is rejected");
+
+    x->long_attr = -1;
+    const auto negative = schema.snapshot(x);
+    schema.restore(x, a);
+    check(schema.restore(x, negative) != MAX_ERR_NONE && same_values(x, &saved), "predicate is checked on restore");
+
+    outlet_int(x->outlet, ok);
+}
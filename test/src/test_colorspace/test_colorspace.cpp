@@ -0,0 +1,108 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#include <cstdlib>
+#include <random>
+
+#include "ext.h"
+#include "magic_enum.hpp"
+#include "maxutils/colorspace.hpp"
+#include "maxutils/named_matrix.hpp"
+
+using namespace c74::max;
+
+struct t_test_colorspace {
+    t_object ob;
+    t_outlet *outlet;
+};
+
+static t_class *c;
+
+BEGIN_USING_C_LINKAGE
+
+t_test_colorspace *test_colorspace_new(t_symbol *s, long argc, t_atom *argv);
+void test_colorspace_free(t_test_colorspace *x);
+void test_colorspace_bang(t_test_colorspace *x);
+
+void ext_main(void *) {
+    c = class_new("test_colorspace", (method)test_colorspace_new, (method)test_colorspace_free,
+                  sizeof(t_test_colorspace), nullptr, A_GIMME, 0);
+    class_addmethod(c, (method)test_colorspace_bang, "bang", 0);
+    class_register(CLASS_BOX, c);
+}
+
+END_USING_C_LINKAGE
+
+t_test_colorspace *test_colorspace_new(t_symbol *s, long argc, t_atom *argv) {
+    auto *x = (t_test_colorspace *)object_alloc(c);
+    x->outlet = outlet_new(x, nullptr);
+    return x;
+}
+
+void test_colorspace_free(t_test_colorspace *x) {
+    outlet_delete(x->outlet);
+}
+
+static int lsb_difference(char a, char b) {
+    return std::abs(static_cast<int>(static_cast<uint8_t>(a)) - static_cast<int>(static_cast<uint8_t>(b)));
+}
+
+// Converts random ARGB char cells to each colour space in float32 and back, and outputs 1 if every channel
+// comes back within 1 LSB with alpha intact.
+void test_colorspace_bang(t_test_colorspace *x) {
+    using maxutils::color_space;
+    constexpr long width = 67, height = 13;
+    NamedMatrix rgb{_jit_sym_char, {width, height}, 4};
+    NamedMatrix converted{_jit_sym_float32, {width, height}, 3};
+    NamedMatrix back{_jit_sym_char, {width, height}, 4};
+    maxutils::matrix_view<char> rgb_view{(t_object *)rgb.matrix};
+    maxutils::matrix_view<float> converted_view{(t_object *)converted.matrix};
+    maxutils::matrix_view<char> back_view{(t_object *)back.matrix};
+
+    std::mt19937 rng{40};
+    for (long y = 0; y < height; ++y) {
+        for (long i = 0; i < width; ++i) {
+            for (long p = 0; p < 4; ++p) {
+                rgb_view.at(i, y)[p] = static_cast<char>(rng() % 256);
+            }
+        }
+    }
+    // greys and primaries, where hue is undefined or the conversions clip
+    for (long i = 0; i < 8; ++i) {
+        auto cell = rgb_view.at(i, 0);
+        cell[1] = (i & 1) ? static_cast<char>(255) : 0;
+        cell[2] = (i & 2) ? static_cast<char>(255) : 0;
+        cell[3] = (i & 4) ? static_cast<char>(255) : 0;
+    }
+
+    bool ok = true;
+    for (auto space: {color_space::rgb, color_space::yuv, color_space::hsv, color_space::lab}) {
+        const auto name = magic_enum::enum_name(space).data();
+        if (maxutils::convert_color(rgb_view, color_space::rgb, converted_view, space)
+            || maxutils::convert_color(converted_view, space, back_view, color_space::rgb)) {
+            object_error((t_object *)x, "failed: converting to and from %s", name);
+            ok = false;
+            continue;
+        }
+        int worst = 0;
+        for (long y = 0; y < height; ++y) {
+            for (long i = 0; i < width; ++i) {
+                for (long p = 1; p < 4; ++p) {
+                    worst = std::max(worst, lsb_difference(rgb_view.at(i, y)[p], back_view.at(i, y)[p]));
+                }
+            }
+        }
+        if (worst > 1) {
+            object_error((t_object *)x, "failed: rgb -> %s -> rgb is off by %d", name, worst);
+            ok = false;
+        }
+        // 3-plane src into ARGB dst: alpha is set to opaque
+        if (static_cast<uint8_t>(back_view.at(0, 0)[0]) != 255) {
+            object_error((t_object *)x, "failed: alpha after %s", name);
+            ok = false;
+        }
+    }
+
+    outlet_int(x->outlet, ok);
+}
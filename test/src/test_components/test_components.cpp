@@ -0,0 +1,177 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include "ext.h"
+#include "maxutils/components.hpp"
+#include "maxutils/named_matrix.hpp"
+
+using namespace c74::max;
+
+struct t_test_components {
+    t_object ob;
+    t_outlet *outlet;
+};
+
+static t_class *c;
+
+BEGIN_USING_C_LINKAGE
+
+t_test_components *test_components_new(t_symbol *s, long argc, t_atom *argv);
+void test_components_free(t_test_components *x);
+void test_components_bang(t_test_components *x);
+
+void ext_main(void *) {
+    c = class_new("test_components", (method)test_components_new, (method)test_components_free,
+                  sizeof(t_test_components), nullptr, A_GIMME, 0);
+    class_addmethod(c, (method)test_components_bang, "bang", 0);
+    class_register(CLASS_BOX, c);
+}
+
+END_USING_C_LINKAGE
+
+t_test_components *test_components_new(t_symbol *s, long argc, t_atom *argv) {
+    auto *x = (t_test_components *)object_alloc(c);
+    x->outlet = outlet_new(x, nullptr);
+    return x;
+}
+
+void test_components_free(t_test_components *x) {
+    outlet_delete(x->outlet);
+}
+
+constexpr long width = 24, height = 40;
+
+// Flood fills the mask in raster order, which numbers blobs the way label_components does.
+static std::vector<int32_t> reference_labels(maxutils::matrix_view<char> &mask, maxutils::connectivity conn,
+                                             unsigned char threshold) {
+    std::vector<int32_t> labels(width * height, 0);
+    std::vector<long> stack;
+    int32_t next = 0;
+    const auto foreground = [&](long i, long y) {
+        return static_cast<unsigned char>(mask.at(i, y)[0]) > threshold;
+    };
+    for (long y = 0; y < height; ++y) {
+        for (long i = 0; i < width; ++i) {
+            if (!foreground(i, y) || labels[y * width + i]) {
+                continue;
+            }
+            labels[y * width + i] = ++next;
+            stack.push_back(y * width + i);
+            while (!stack.empty()) {
+                const long cx = stack.back() % width, cy = stack.back() / width;
+                stack.pop_back();
+                for (long dy = -1; dy <= 1; ++dy) {
+                    for (long dx = -1; dx <= 1; ++dx) {
+                        const long nx = cx + dx, ny = cy + dy;
+                        if ((dx && dy && conn == maxutils::connectivity::four) || nx < 0 || ny < 0 || nx >= width
+                            || ny >= height || !foreground(nx, ny) || labels[ny * width + nx]) {
+                            continue;
+                        }
+                        labels[ny * width + nx] = next;
+                        stack.push_back(ny * width + nx);
+                    }
+                }
+            }
+        }
+    }
+    return labels;
+}
+
+// Labels a fixed mask whose blobs cross the 16-row strip boundaries, straight down, diagonally and as a U
+// joined only below the cut, under both connectivities and two thresholds. Checks the counts, the labels
+// against a flood fill and the stats of two blobs worked out by hand, and outputs 1 if everything passes.
+void test_components_bang(t_test_components *x) {
+    using maxutils::connectivity;
+    bool ok = true;
+    const auto check = [&](bool condition, const char *what) {
+        if (!condition) {
+            object_error((t_object *)x, "failed: %s", what);
+            ok = false;
+        }
+    };
+
+    NamedMatrix mask{_jit_sym_char, {width, height}, 1};
+    NamedMatrix labels{_jit_sym_long, {width, height}, 1};
+    maxutils::matrix_view<char> mask_view{(t_object *)mask.matrix};
+    maxutils::matrix_view<int32_t> labels_view{(t_object *)labels.matrix};
+    const auto set = [&](long i, long y, unsigned char v = 200) {
+        mask_view.at(i, y)[0] = static_cast<char>(v);
+    };
+    for (long y = 0; y < height; ++y) {
+        for (auto &v: mask_view.row(y).as_1d_span()) {
+            v = 0;
+        }
+    }
+    // a rectangle
+    for (long y = 1; y <= 3; ++y) {
+        for (long i = 2; i <= 5; ++i) {
+            set(i, y);
+        }
+    }
+    // a diagonal pair
+    set(20, 5);
+    set(21, 6);
+    // a bar down across the first cut
+    for (long y = 10; y <= 25; ++y) {
+        set(10, y);
+    }
+    // a diagonal pair across the first cut
+    set(14, 15);
+    set(15, 16);
+    // a U whose arms only meet below the second cut
+    for (long y = 28; y <= 33; ++y) {
+        set(3, y);
+        set(7, y);
+    }
+    for (long i = 3; i <= 7; ++i) {
+        set(i, 34);
+    }
+    // a faint cell
+    set(15, 38, 10);
+
+    struct expectation {
+        connectivity conn;
+        unsigned char threshold;
+        size_t count;
+    };
+    for (const auto &e: {expectation{connectivity::eight, 0, 6}, expectation{connectivity::four, 0, 8},
+                         expectation{connectivity::eight, 20, 5}}) {
+        std::array<maxutils::blob_stats, 8> stats{};
+        size_t count = 0;
+        const auto err = maxutils::label_components(mask_view, labels_view, stats, count, e.conn, e.threshold);
+        check(err == JIT_ERR_NONE, "label_components returned an error");
+        check(count == e.count, "wrong number of blobs");
+
+        const auto expected = reference_labels(mask_view, e.conn, e.threshold);
+        bool matches = true;
+        for (long y = 0; y < height; ++y) {
+            for (long i = 0; i < width; ++i) {
+                matches = matches && labels_view.at(i, y)[0] == expected[y * width + i];
+            }
+        }
+        check(matches, "labels differ from a flood fill");
+
+        const auto &rectangle = stats[0];
+        check(rectangle.area == 12 && rectangle.min_x == 2 && rectangle.min_y == 1 && rectangle.max_x == 5
+              && rectangle.max_y == 3 && rectangle.centroid_x == 3.5 && rectangle.centroid_y == 2.0,
+              "wrong stats for the rectangle");
+        // the U is the last blob but the faint cell, if that's counted
+        const auto &u = stats[e.threshold ? e.count - 1 : e.count - 2];
+        check(u.area == 17 && u.min_x == 3 && u.min_y == 28 && u.max_x == 7 && u.max_y == 34
+              && std::abs(u.centroid_x - 5.0) < 1e-12 && std::abs(u.centroid_y - 536.0 / 17.0) < 1e-12,
+              "wrong stats for the U");
+    }
+
+    // blobs past the end of the stats span are still labelled and counted
+    std::array<maxutils::blob_stats, 2> few{};
+    size_t count = 0;
+    check(maxutils::label_components(mask_view, labels_view, few, count) == JIT_ERR_NONE && count == 6
+          && few[1].area == 2, "short stats span changes the count");
+
+    outlet_int(x->outlet, ok);
+}
@@ -0,0 +1,173 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include "ext.h"
+#include "magic_enum.hpp"
+#include "maxutils/convolve.hpp"
+#include "maxutils/named_matrix.hpp"
+
+using namespace c74::max;
+
+struct t_test_convolve {
+    t_object ob;
+    t_outlet *outlet;
+};
+
+static t_class *c;
+
+BEGIN_USING_C_LINKAGE
+
+t_test_convolve *test_convolve_new(t_symbol *s, long argc, t_atom *argv);
+void test_convolve_free(t_test_convolve *x);
+void test_convolve_bang(t_test_convolve *x);
+
+void ext_main(void *) {
+    c = class_new("test_convolve", (method)test_convolve_new, (method)test_convolve_free,
+                  sizeof(t_test_convolve), nullptr, A_GIMME, 0);
+    class_addmethod(c, (method)test_convolve_bang, "bang", 0);
+    class_register(CLASS_BOX, c);
+}
+
+END_USING_C_LINKAGE
+
+t_test_convolve *test_convolve_new(t_symbol *s, long argc, t_atom *argv) {
+    auto *x = (t_test_convolve *)object_alloc(c);
+    x->outlet = outlet_new(x, nullptr);
+    return x;
+}
+
+void test_convolve_free(t_test_convolve *x) {
+    outlet_delete(x->outlet);
+}
+
+// Straightforward correlation of one plane, reading out-of-range cells through bound_index.
+static float reference_cell(maxutils::matrix_view<float> &src, const maxutils::convolution_kernel &kernel,
+                            maxutils::boundmode bounds, long i, long j, long plane) {
+    float sum = 0.0f;
+    for (long ky = 0; ky < kernel.height(); ++ky) {
+        for (long kx = 0; kx < kernel.width(); ++kx) {
+            const long sx = maxutils::detail::bound_index(i + kx - kernel.width() / 2, src.ncols(), bounds);
+            const long sy = maxutils::detail::bound_index(j + ky - kernel.height() / 2, src.nrows(), bounds);
+            if (sx >= 0 && sy >= 0) {
+                sum += kernel.at(kx, ky) * src.at(sx, sy)[plane];
+            }
+        }
+    }
+    return sum;
+}
+
+// Runs every implementation against a direct reference over each bound mode but ignore, with a separable
+// Gaussian and a non-separable kernel, then on a long matrix, where results are rounded and saturate at the
+// int32 range. Outputs 1 if they all agree.
+void test_convolve_bang(t_test_convolve *x) {
+    using maxutils::boundmode;
+    using maxutils::convolve_method;
+    constexpr long width = 45, height = 31, planes = 2;
+    NamedMatrix src{_jit_sym_float32, {width, height}, planes};
+    NamedMatrix dst{_jit_sym_float32, {width, height}, planes};
+    maxutils::matrix_view<float> src_view{(t_object *)src.matrix};
+    maxutils::matrix_view<float> dst_view{(t_object *)dst.matrix};
+
+    std::mt19937 rng{38};
+    std::uniform_real_distribution<float> value{0.0f, 1.0f};
+    for (long y = 0; y < height; ++y) {
+        for (auto &v: src_view.row(y).as_1d_span()) {
+            v = value(rng);
+        }
+    }
+
+    const maxutils::convolution_kernel gaussian = maxutils::convolution_kernel::gaussian(1.5f, 7);
+    const maxutils::convolution_kernel edges{3, 3, {0.0f, -1.0f, 0.5f, -1.0f, 4.0f, -1.0f, 0.25f, -1.0f, 0.0f}};
+
+    bool ok = true;
+    const auto check = [&](bool condition, const char *what, const char *method, const char *bounds) {
+        if (!condition) {
+            object_error((t_object *)x, "failed: %s (%s, %s)", what, method, bounds);
+            ok = false;
+        }
+    };
+
+    for (const auto *kernel: {&gaussian, &edges}) {
+        for (auto method: {convolve_method::direct, convolve_method::separable, convolve_method::fft}) {
+            if (method == convolve_method::separable && !kernel->separable()) {
+                continue;
+            }
+            for (auto bounds: {boundmode::clear, boundmode::wrap, boundmode::fold, boundmode::clip}) {
+                const auto method_name = magic_enum::enum_name(method).data();
+                const auto bounds_name = magic_enum::enum_name(bounds).data();
+                const auto err = maxutils::convolve(src_view, dst_view, *kernel, bounds, method);
+                check(err == JIT_ERR_NONE, "convolve returned an error", method_name, bounds_name);
+                float worst = 0.0f;
+                for (long y = 0; y < height; ++y) {
+                    for (long i = 0; i < width; ++i) {
+                        for (long p = 0; p < planes; ++p) {
+                            const float expected = reference_cell(src_view, *kernel, bounds, i, y, p);
+                            worst = std::max(worst, std::abs(dst_view.at(i, y)[p] - expected));
+                        }
+                    }
+                }
+                check(worst < 1e-4f, "result differs from the reference", method_name, bounds_name);
+            }
+        }
+    }
+
+    check(maxutils::convolve(src_view, src_view, gaussian) == JIT_ERR_INVALID_OUTPUT,
+          "in place convolution is rejected", "automatic", "clip");
+
+    NamedMatrix long_src{_jit_sym_long, {width, height}, 1};
+    NamedMatrix long_dst{_jit_sym_long, {width, height}, 1};
+    maxutils::matrix_view<int32_t> long_src_view{(t_object *)long_src.matrix};
+    maxutils::matrix_view<int32_t> long_dst_view{(t_object *)long_dst.matrix};
+    const maxutils::convolution_kernel binomial{3, 3, {1.0f, 2.0f, 1.0f, 2.0f, 4.0f, 2.0f, 1.0f, 2.0f, 1.0f}};
+    const auto fill_long = [&](auto &&fn) {
+        for (long y = 0; y < height; ++y) {
+            for (long i = 0; i < width; ++i) {
+                long_src_view.at(i, y)[0] = fn(i, y);
+            }
+        }
+    };
+    const auto all_long = [&](auto &&fn) {
+        for (long y = 0; y < height; ++y) {
+            for (long i = 0; i < width; ++i) {
+                if (long_dst_view.at(i, y)[0] != fn(i, y)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+    for (auto method: {convolve_method::direct, convolve_method::separable, convolve_method::fft}) {
+        const auto method_name = magic_enum::enum_name(method).data();
+        // small integers, which every method should reproduce exactly after rounding
+        fill_long([](long i, long y) { return static_cast<int32_t>((i * 37 + y * 11) % 1000); });
+        check(maxutils::convolve(long_src_view, long_dst_view, binomial, boundmode::wrap, method) == JIT_ERR_NONE,
+              "convolve returned an error", method_name, "long");
+        check(all_long([&](long i, long y) {
+            long sum = 0;
+            for (long ky = 0; ky < 3; ++ky) {
+                for (long kx = 0; kx < 3; ++kx) {
+                    const long sx = (i + kx - 1 + width) % width, sy = (y + ky - 1 + height) % height;
+                    sum += std::lround(binomial.at(kx, ky)) * long_src_view.at(sx, sy)[0];
+                }
+            }
+            return static_cast<int32_t>(sum);
+        }), "result differs from the reference", method_name, "long");
+
+        // sixteen times anything near the int32 limits is out of range
+        for (const int32_t v: {2000000000, -2000000000}) {
+            fill_long([v](long, long) { return v; });
+            check(maxutils::convolve(long_src_view, long_dst_view, binomial, boundmode::clip, method) == JIT_ERR_NONE
+                  && all_long([v](long, long) {
+                      return v > 0 ? std::numeric_limits<int32_t>::max() : std::numeric_limits<int32_t>::min();
+                  }), "out of range results don't saturate", method_name, "long");
+        }
+    }
+
+    outlet_int(x->outlet, ok);
+}
@@ -0,0 +1,148 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "ext.h"
+#include "maxutils/lut.hpp"
+#include "maxutils/named_matrix.hpp"
+
+using namespace c74::max;
+
+struct t_test_lut {
+    t_object ob;
+    t_outlet *outlet;
+};
+
+static t_class *c;
+
+BEGIN_USING_C_LINKAGE
+
+t_test_lut *test_lut_new(t_symbol *s, long argc, t_atom *argv);
+void test_lut_free(t_test_lut *x);
+void test_lut_bang(t_test_lut *x);
+
+void ext_main(void *) {
+    c = class_new("test_lut", (method)test_lut_new, (method)test_lut_free, sizeof(t_test_lut), nullptr, A_GIMME, 0);
+    class_addmethod(c, (method)test_lut_bang, "bang", 0);
+    class_register(CLASS_BOX, c);
+}
+
+END_USING_C_LINKAGE
+
+t_test_lut *test_lut_new(t_symbol *s, long argc, t_atom *argv) {
+    auto *x = (t_test_lut *)object_alloc(c);
+    x->outlet = outlet_new(x, nullptr);
+    return x;
+}
+
+void test_lut_free(t_test_lut *x) {
+    outlet_delete(x->outlet);
+}
+
+// Looks every cell of src up in the lut's tables one at a time and compares with dst.
+static bool matches_tables(maxutils::matrix_view<char> &src, maxutils::matrix_view<char> &dst,
+                           const maxutils::plane_lut &lut) {
+    const long planes = src.planecount();
+    for (long y = 0; y < src.nrows(); ++y) {
+        for (long i = 0; i < src.ncols(); ++i) {
+            for (long p = 0; p < planes; ++p) {
+                const auto &table = lut.get_table(lut.planecount() == 1 ? 0 : p);
+                if (static_cast<uint8_t>(dst.at(i, y)[p]) != table[static_cast<uint8_t>(src.at(i, y)[p])]) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Checks plane_lut against per-cell table lookups for each of the row kernels, that moving a curve point
+// updates the table as a full refill would, and that colour cubes built from affine functions reproduce them
+// under both interpolations. Outputs 1 if everything passes.
+void test_lut_bang(t_test_lut *x) {
+    bool ok = true;
+    const auto check = [&](bool condition, const char *what) {
+        if (!condition) {
+            object_error((t_object *)x, "failed: %s", what);
+            ok = false;
+        }
+    };
+
+    std::mt19937 rng{39};
+    constexpr long width = 37, height = 9;
+    for (long planes: {4l, 3l, 1l}) {
+        NamedMatrix src{_jit_sym_char, {width, height}, planes};
+        NamedMatrix dst{_jit_sym_char, {width, height}, planes};
+        maxutils::matrix_view<char> src_view{(t_object *)src.matrix};
+        maxutils::matrix_view<char> dst_view{(t_object *)dst.matrix};
+        std::uniform_int_distribution<int> byte{0, 255};
+        for (long y = 0; y < height; ++y) {
+            for (auto &v: src_view.row(y).as_1d_span()) {
+                v = static_cast<char>(byte(rng));
+            }
+        }
+
+        maxutils::plane_lut lut{planes};
+        lut.fill(0, [](float v) { return 1.0f - v; });
+        if (planes > 1) {
+            lut.set_gamma(1, 2.2f);
+            for (int i = 0; i < 256; ++i) {
+                lut.set_entry(2, static_cast<uint8_t>(i), static_cast<uint8_t>(byte(rng)));
+            }
+        }
+        check(maxutils::apply_lut(src_view, dst_view, lut) == JIT_ERR_NONE, "plane_lut returned an error");
+        check(matches_tables(src_view, dst_view, lut), "plane_lut differs from table lookups");
+
+        maxutils::plane_lut shared{1};
+        shared.set_gamma(0, 0.45f);
+        check(maxutils::apply_lut(src_view, dst_view, shared) == JIT_ERR_NONE, "shared table returned an error");
+        check(matches_tables(src_view, dst_view, shared), "shared table differs from table lookups");
+    }
+
+    maxutils::plane_lut moved{1};
+    maxutils::plane_lut refilled{1};
+    moved.set_curve(0, maxutils::tone_curve{{{0.0f, 0.0f}, {0.25f, 0.3f}, {0.5f, 0.5f}, {0.75f, 0.8f}, {1.0f, 1.0f}}});
+    moved.move_point(0, 2, 0.4f, 0.7f);
+    refilled.set_curve(0, moved.curve(0));
+    check(moved.get_table(0) == refilled.get_table(0), "moving a curve point leaves stale table entries");
+
+    NamedMatrix argb{_jit_sym_float32, {width, height}, 4};
+    NamedMatrix graded{_jit_sym_float32, {width, height}, 4};
+    maxutils::matrix_view<float> argb_view{(t_object *)argb.matrix};
+    maxutils::matrix_view<float> graded_view{(t_object *)graded.matrix};
+    // slightly outside [0, 1] so clamping is exercised too
+    std::uniform_real_distribution<float> value{-0.1f, 1.1f};
+    for (long y = 0; y < height; ++y) {
+        for (auto &v: argb_view.row(y).as_1d_span()) {
+            v = value(rng);
+        }
+    }
+    // affine in each channel, which both interpolations reproduce exactly between lattice points
+    const auto grade = [](maxutils::color_lut::rgb in) -> maxutils::color_lut::rgb {
+        return {0.6f * in[0] + 0.3f * in[1] + 0.05f, 0.2f * in[0] + 0.7f * in[2], 0.1f + 0.8f * in[2] - 0.1f * in[1]};
+    };
+    const auto cube = maxutils::color_lut::from_function(17, grade);
+    for (auto interp: {maxutils::lut_interp::trilinear, maxutils::lut_interp::tetrahedral}) {
+        check(maxutils::apply_lut(argb_view, graded_view, cube, interp) == JIT_ERR_NONE, "colour cube returned an error");
+        float worst = 0.0f;
+        for (long y = 0; y < height; ++y) {
+            for (long i = 0; i < width; ++i) {
+                const auto in = argb_view.at(i, y);
+                const auto out = graded_view.at(i, y);
+                const auto expected = grade({std::clamp(in[1], 0.0f, 1.0f), std::clamp(in[2], 0.0f, 1.0f),
+                                             std::clamp(in[3], 0.0f, 1.0f)});
+                check(out[0] == in[0], "colour cube changed alpha");
+                for (int k = 0; k < 3; ++k) {
+                    worst = std::max(worst, std::abs(out[k + 1] - expected[k]));
+                }
+            }
+        }
+        check(worst < 1e-5f, "colour cube doesn't reproduce an affine grade");
+    }
+
+    outlet_int(x->outlet, ok);
+}
@@ -0,0 +1,143 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#include <algorithm>
+#include <random>
+
+#include "ext.h"
+#include "magic_enum.hpp"
+#include "maxutils/named_matrix.hpp"
+#include "maxutils/orient.hpp"
+
+using namespace c74::max;
+
+struct t_test_orient {
+    t_object ob;
+    t_outlet *outlet;
+};
+
+static t_class *c;
+
+BEGIN_USING_C_LINKAGE
+
+t_test_orient *test_orient_new(t_symbol *s, long argc, t_atom *argv);
+void test_orient_free(t_test_orient *x);
+void test_orient_bang(t_test_orient *x);
+
+void ext_main(void *) {
+    c = class_new("test_orient", (method)test_orient_new, (method)test_orient_free, sizeof(t_test_orient), nullptr,
+                  A_GIMME, 0);
+    class_addmethod(c, (method)test_orient_bang, "bang", 0);
+    class_register(CLASS_BOX, c);
+}
+
+END_USING_C_LINKAGE
+
+t_test_orient *test_orient_new(t_symbol *s, long argc, t_atom *argv) {
+    auto *x = (t_test_orient *)object_alloc(c);
+    x->outlet = outlet_new(x, nullptr);
+    return x;
+}
+
+void test_orient_free(t_test_orient *x) {
+    outlet_delete(x->outlet);
+}
+
+template <typename T>
+static bool same_cells(maxutils::matrix_view<T> &a, maxutils::matrix_view<T> &b) {
+    for (long y = 0; y < a.nrows(); ++y) {
+        const auto ra = a.row(y).as_1d_span(), rb = b.row(y).as_1d_span();
+        if (!std::equal(ra.begin(), ra.end(), rb.begin())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Checks every orientation of a width x height matrix with the given cell type and planecount against the
+// orientation's definition, then that rotating by 90 degrees four times, and applying each self-inverse
+// orientation twice, gives back the input.
+template <typename T>
+static void check_orientations(t_test_orient *x, t_symbol *type, long planes, bool &ok) {
+    using maxutils::orientation;
+    constexpr long width = 37, height = 23;
+    const auto check = [&](bool condition, const char *what, orientation o) {
+        if (!condition) {
+            object_error((t_object *)x, "failed: %s (%s, %ld planes)", what, magic_enum::enum_name(o).data(), planes);
+            ok = false;
+        }
+    };
+
+    NamedMatrix src{type, {width, height}, planes};
+    NamedMatrix wide{type, {width, height}, planes};
+    NamedMatrix tall{type, {height, width}, planes};
+    NamedMatrix back{type, {width, height}, planes};
+    maxutils::matrix_view<T> src_view{(t_object *)src.matrix};
+    maxutils::matrix_view<T> wide_view{(t_object *)wide.matrix};
+    maxutils::matrix_view<T> tall_view{(t_object *)tall.matrix};
+    maxutils::matrix_view<T> back_view{(t_object *)back.matrix};
+
+    std::mt19937 rng{43};
+    std::uniform_int_distribution<int> value{0, 255};
+    for (long y = 0; y < height; ++y) {
+        for (auto &v: src_view.row(y).as_1d_span()) {
+            v = static_cast<T>(value(rng));
+        }
+    }
+
+    for (auto o: magic_enum::enum_values<orientation>()) {
+        const auto map = maxutils::detail::map_of(o);
+        auto &dst = map.swap ? tall_view : wide_view;
+        check(maxutils::reorient(src_view, dst, o) == JIT_ERR_NONE, "reorient returned an error", o);
+        bool matches = true;
+        for (long y = 0; y < dst.nrows(); ++y) {
+            for (long i = 0; i < dst.ncols(); ++i) {
+                const long u = map.swap ? y : i, v = map.swap ? i : y;
+                const auto expected = src_view.at(map.rev_x ? width - 1 - u : u, map.rev_y ? height - 1 - v : v);
+                const auto actual = dst.at(i, y);
+                for (long p = 0; p < planes; ++p) {
+                    matches = matches && actual[p] == expected[p];
+                }
+            }
+        }
+        check(matches, "result doesn't match the orientation's definition", o);
+    }
+
+    check(maxutils::reorient(src_view, tall_view, orientation::rotate90) == JIT_ERR_NONE
+          && maxutils::reorient(tall_view, wide_view, orientation::rotate90) == JIT_ERR_NONE
+          && maxutils::reorient(wide_view, tall_view, orientation::rotate90) == JIT_ERR_NONE
+          && maxutils::reorient(tall_view, back_view, orientation::rotate90) == JIT_ERR_NONE
+          && same_cells(src_view, back_view), "four quarter turns aren't the identity", orientation::rotate90);
+
+    check(maxutils::reorient(src_view, tall_view, orientation::rotate90) == JIT_ERR_NONE
+          && maxutils::reorient(tall_view, back_view, orientation::rotate270) == JIT_ERR_NONE
+          && same_cells(src_view, back_view), "rotate270 doesn't undo rotate90", orientation::rotate270);
+
+    for (auto o: {orientation::rotate180, orientation::flip_x, orientation::flip_y}) {
+        check(maxutils::reorient(src_view, wide_view, o) == JIT_ERR_NONE
+              && maxutils::reorient(wide_view, back_view, o) == JIT_ERR_NONE
+              && same_cells(src_view, back_view), "applying twice isn't the identity", o);
+    }
+    for (auto o: {orientation::transpose, orientation::transverse}) {
+        check(maxutils::reorient(src_view, tall_view, o) == JIT_ERR_NONE
+              && maxutils::reorient(tall_view, back_view, o) == JIT_ERR_NONE
+              && same_cells(src_view, back_view), "applying twice isn't the identity", o);
+    }
+
+    check(maxutils::reorient(src_view, src_view, orientation::flip_x) == JIT_ERR_INVALID_OUTPUT,
+          "in place reorientation is accepted", orientation::flip_x);
+}
+
+// Runs the checks for char and float32 matrices with one and several planes, covering the 1, 3, 4, 12 and 16
+// byte cell paths, and outputs 1 if they all pass.
+void test_orient_bang(t_test_orient *x) {
+    bool ok = true;
+    check_orientations<char>(x, _jit_sym_char, 1, ok);
+    check_orientations<char>(x, _jit_sym_char, 3, ok);
+    check_orientations<char>(x, _jit_sym_char, 4, ok);
+    check_orientations<float>(x, _jit_sym_float32, 1, ok);
+    check_orientations<float>(x, _jit_sym_float32, 3, ok);
+    check_orientations<float>(x, _jit_sym_float32, 4, ok);
+    outlet_int(x->outlet, ok);
+}
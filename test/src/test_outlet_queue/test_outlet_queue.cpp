@@ -0,0 +1,135 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#include <array>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ext.h"
+#include "maxutils/outlet_queue.hpp"
+
+using namespace c74::max;
+
+struct t_test_outlet_queue {
+    t_object ob;
+    t_outlet *outlet;
+    maxutils::outlet_queue<> *queue;
+    std::vector<std::string> *received;
+};
+
+static t_class *c;
+
+BEGIN_USING_C_LINKAGE
+
+t_test_outlet_queue *test_outlet_queue_new(t_symbol *s, long argc, t_atom *argv);
+void test_outlet_queue_free(t_test_outlet_queue *x);
+void test_outlet_queue_bang(t_test_outlet_queue *x);
+void test_outlet_queue_int(t_test_outlet_queue *x, t_atom_long n);
+void test_outlet_queue_float(t_test_outlet_queue *x, double f);
+void test_outlet_queue_list(t_test_outlet_queue *x, t_symbol *s, long argc, t_atom *argv);
+void test_outlet_queue_anything(t_test_outlet_queue *x, t_symbol *s, long argc, t_atom *argv);
+
+void ext_main(void *) {
+    c = class_new("test_outlet_queue", (method)test_outlet_queue_new, (method)test_outlet_queue_free,
+                  sizeof(t_test_outlet_queue), nullptr, A_GIMME, 0);
+    class_addmethod(c, (method)test_outlet_queue_bang, "bang", 0);
+    class_addmethod(c, (method)test_outlet_queue_int, "int", A_LONG, 0);
+    class_addmethod(c, (method)test_outlet_queue_float, "float", A_FLOAT, 0);
+    class_addmethod(c, (method)test_outlet_queue_list, "list", A_GIMME, 0);
+    class_addmethod(c, (method)test_outlet_queue_anything, "anything", A_GIMME, 0);
+    class_register(CLASS_BOX, c);
+}
+
+END_USING_C_LINKAGE
+
+// The queue's outlet (the right one) is patched back into the inlet, which records what arrives.
+t_test_outlet_queue *test_outlet_queue_new(t_symbol *s, long argc, t_atom *argv) {
+    auto *x = (t_test_outlet_queue *)object_alloc(c);
+    x->queue = new maxutils::outlet_queue<>{(t_object *)x};
+    x->outlet = outlet_new(x, nullptr);
+    x->received = new std::vector<std::string>;
+    return x;
+}
+
+void test_outlet_queue_free(t_test_outlet_queue *x) {
+    delete x->received;
+    delete x->queue;
+    outlet_delete(x->outlet);
+}
+
+static std::string describe(const char *selector, long argc, const t_atom *argv) {
+    std::string text = selector;
+    for (long i = 0; i < argc; ++i) {
+        switch (atom_gettype(argv + i)) {
+            case A_LONG: text += " " + std::to_string(atom_getlong(argv + i)); break;
+            case A_FLOAT: text += " " + std::to_string(atom_getfloat(argv + i)) + "f"; break;
+            case A_SYM: text += std::string{" "} + atom_getsym(argv + i)->s_name; break;
+            default: text += " ?"; break;
+        }
+    }
+    return text;
+}
+
+// Pushes one of each kind of message from a worker thread, then "done". Nothing is output until the queue's
+// qelem drains it on the main thread; when "done" arrives the messages recorded before it are compared with
+// what was pushed and 1 is output if they match.
+void test_outlet_queue_bang(t_test_outlet_queue *x) {
+    x->received->clear();
+    bool pushed = true;
+    std::thread worker{[x, &pushed] {
+        auto &q = *x->queue;
+        const std::array<float, 3> values{1.0f, 2.5f, 3.0f};
+        std::array<t_atom, 2> atoms;
+        atom_setsym(&atoms[0], gensym("a"));
+        atom_setlong(&atoms[1], 7);
+        pushed = q.push(1) && q.push(2l) && q.push(3000000000ll) && q.push(true) && q.push(1.5f) && q.push(0.25)
+                 && q.push_list(std::span<const float>{values}) && q.push_list(std::span<const t_atom>{atoms})
+                 && q.push_anything(gensym("set"), atoms) && q.push_anything(gensym("done"));
+    }};
+    worker.join();
+    if (!pushed) {
+        object_error((t_object *)x, "failed: push was refused");
+        outlet_int(x->outlet, 0);
+    }
+}
+
+void test_outlet_queue_int(t_test_outlet_queue *x, t_atom_long n) {
+    t_atom a;
+    atom_setlong(&a, n);
+    x->received->push_back(describe("int", 1, &a));
+}
+
+void test_outlet_queue_float(t_test_outlet_queue *x, double f) {
+    t_atom a;
+    atom_setfloat(&a, f);
+    x->received->push_back(describe("float", 1, &a));
+}
+
+void test_outlet_queue_list(t_test_outlet_queue *x, t_symbol *s, long argc, t_atom *argv) {
+    x->received->push_back(describe("list", argc, argv));
+}
+
+void test_outlet_queue_anything(t_test_outlet_queue *x, t_symbol *s, long argc, t_atom *argv) {
+    if (s != gensym("done")) {
+        x->received->push_back(describe(s->s_name, argc, argv));
+        return;
+    }
+    const std::vector<std::string> expected{
+        "int 1", "int 2", "int 3000000000", "int 1", "float 1.500000f", "float 0.250000f",
+        "list 1.000000f 2.500000f 3.000000f", "list a 7", "set a 7",
+    };
+    bool ok = *x->received == expected;
+    if (!ok) {
+        object_error((t_object *)x, "failed: the outlet sent %ld messages, not those pushed", x->received->size());
+        for (const auto &m: *x->received) {
+            object_error((t_object *)x, "received: %s", m.c_str());
+        }
+    }
+    if (x->queue->dropped() != 0) {
+        object_error((t_object *)x, "failed: messages were dropped");
+        ok = false;
+    }
+    outlet_int(x->outlet, ok);
+}
@@ -0,0 +1,128 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "ext.h"
+#include "maxutils/named_matrix.hpp"
+#include "maxutils/rank_filter.hpp"
+
+using namespace c74::max;
+
+struct t_test_rank_filter {
+    t_object ob;
+    t_outlet *outlet;
+};
+
+static t_class *c;
+
+BEGIN_USING_C_LINKAGE
+
+t_test_rank_filter *test_rank_filter_new(t_symbol *s, long argc, t_atom *argv);
+void test_rank_filter_free(t_test_rank_filter *x);
+void test_rank_filter_bang(t_test_rank_filter *x);
+
+void ext_main(void *) {
+    c = class_new("test_rank_filter", (method)test_rank_filter_new, (method)test_rank_filter_free,
+                  sizeof(t_test_rank_filter), nullptr, A_GIMME, 0);
+    class_addmethod(c, (method)test_rank_filter_bang, "bang", 0);
+    class_register(CLASS_BOX, c);
+}
+
+END_USING_C_LINKAGE
+
+t_test_rank_filter *test_rank_filter_new(t_symbol *s, long argc, t_atom *argv) {
+    auto *x = (t_test_rank_filter *)object_alloc(c);
+    x->outlet = outlet_new(x, nullptr);
+    return x;
+}
+
+void test_rank_filter_free(t_test_rank_filter *x) {
+    outlet_delete(x->outlet);
+}
+
+// Filters a random matrix with each window and rank and compares every cell with std::nth_element over its
+// edge-clamped window. char cells are ordered as unsigned, like Jitter's.
+template <typename T>
+static void check_against_nth_element(t_test_rank_filter *x, t_symbol *type, long planes, bool &ok) {
+    using key = std::conditional_t<std::is_same_v<T, char>, unsigned char, T>;
+    constexpr long width = 41, height = 37;
+    NamedMatrix src{type, {width, height}, planes};
+    NamedMatrix dst{type, {width, height}, planes};
+    maxutils::matrix_view<T> src_view{(t_object *)src.matrix};
+    maxutils::matrix_view<T> dst_view{(t_object *)dst.matrix};
+
+    std::mt19937 rng{49};
+    // a narrow range so windows hold plenty of ties
+    std::uniform_int_distribution<int> value{0, 40};
+    for (long y = 0; y < height; ++y) {
+        for (auto &v: src_view.row(y).as_1d_span()) {
+            v = static_cast<T>(static_cast<key>(value(rng) * 6));
+        }
+    }
+
+    struct window {
+        long rx;
+        long ry;
+        double rank;
+    };
+    std::vector<key> cells;
+    for (const auto &w: {window{1, 1, 0.5}, window{2, 2, 0.5}, window{1, 2, 0.3}, window{2, 0, 0.0},
+                         window{0, 2, 1.0}, window{3, 3, 0.5}, window{4, 2, 0.8}}) {
+        if (maxutils::rank_filter(src_view, dst_view, w.rx, w.ry, w.rank) != JIT_ERR_NONE) {
+            object_error((t_object *)x, "failed: rank_filter returned an error (%s, %ld x %ld)", type->s_name,
+                         w.rx, w.ry);
+            ok = false;
+            continue;
+        }
+        const long n = (2 * w.rx + 1) * (2 * w.ry + 1);
+        const long k = std::lround(w.rank * (n - 1));
+        long mismatches = 0;
+        for (long y = 0; y < height; ++y) {
+            for (long i = 0; i < width; ++i) {
+                for (long p = 0; p < planes; ++p) {
+                    cells.clear();
+                    for (long dy = -w.ry; dy <= w.ry; ++dy) {
+                        for (long dx = -w.rx; dx <= w.rx; ++dx) {
+                            const long sx = std::clamp(i + dx, 0l, width - 1), sy = std::clamp(y + dy, 0l, height - 1);
+                            cells.push_back(static_cast<key>(src_view.at(sx, sy)[p]));
+                        }
+                    }
+                    std::nth_element(cells.begin(), cells.begin() + k, cells.end());
+                    mismatches += static_cast<key>(dst_view.at(i, y)[p]) != cells[k];
+                }
+            }
+        }
+        if (mismatches) {
+            object_error((t_object *)x, "failed: %ld cells differ from nth_element (%s, %ld planes, %ld x %ld, rank %f)",
+                         mismatches, type->s_name, planes, w.rx, w.ry, w.rank);
+            ok = false;
+        }
+    }
+}
+
+// Covers the char histogram, float sorting network and general selection paths with one and several planes,
+// and outputs 1 if every cell matches.
+void test_rank_filter_bang(t_test_rank_filter *x) {
+    bool ok = true;
+    check_against_nth_element<char>(x, _jit_sym_char, 1, ok);
+    check_against_nth_element<char>(x, _jit_sym_char, 4, ok);
+    check_against_nth_element<float>(x, _jit_sym_float32, 1, ok);
+    check_against_nth_element<float>(x, _jit_sym_float32, 3, ok);
+    check_against_nth_element<int32_t>(x, _jit_sym_long, 1, ok);
+    check_against_nth_element<double>(x, _jit_sym_float64, 2, ok);
+
+    NamedMatrix m{_jit_sym_float32, {8, 8}, 1};
+    maxutils::matrix_view<float> view{(t_object *)m.matrix};
+    if (maxutils::median_filter(view, view, 1) != JIT_ERR_INVALID_OUTPUT) {
+        object_error((t_object *)x, "failed: in place filtering is accepted");
+        ok = false;
+    }
+
+    outlet_int(x->outlet, ok);
+}
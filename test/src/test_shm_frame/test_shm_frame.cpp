@@ -0,0 +1,167 @@
+//
+// Created by Obi Davis on 19/10/2026.
+//
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "maxutils/shm_frame.hpp"
+
+using namespace maxutils;
+
+static int failures = 0;
+
+static void check(bool condition, const char *what) {
+    if (!condition) {
+        std::fprintf(stderr, "failed: %s\n", what);
+        ++failures;
+    }
+}
+
+static shm::matrix_info info_for(int64_t width) {
+    shm::matrix_info info{};
+    std::strcpy(info.type, "char");
+    info.planecount = 1;
+    info.dimcount = 1;
+    info.dim[0] = width;
+    info.dimstride[0] = 1;
+    info.size = width;
+    return info;
+}
+
+// Claims a slot, fills it with `value` and publishes it; returns the slot's data, or nullptr if none was free.
+static const unsigned char *publish_frame(shm_frame_writer &writer, int64_t width, unsigned char value) {
+    unsigned char *data = writer.begin_frame(width);
+    if (!data) {
+        return nullptr;
+    }
+    std::memset(data, value, width);
+    writer.publish(info_for(width));
+    return data;
+}
+
+static bool holds(const shm_frame &frame, int64_t width, unsigned char value) {
+    if (frame.info().size != width || std::strcmp(frame.info().type, "char") != 0) {
+        return false;
+    }
+    for (int64_t i = 0; i < width; ++i) {
+        if (frame.data()[i] != value) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void publish_then_acquire(const std::string &name) {
+    shm_frame_writer writer{name, 64};
+    shm_frame_reader reader{name};
+    check(reader.connected(), "reader doesn't connect to a live writer");
+    check(!reader.acquire(), "a frame is acquired before any was published");
+
+    publish_frame(writer, 16, 1);
+    auto first = reader.acquire();
+    check(first && first->sequence() == 1 && holds(*first, 16, 1), "first frame isn't acquired as published");
+    check(!reader.acquire(1), "the same frame is acquired twice");
+
+    publish_frame(writer, 32, 2);
+    auto second = reader.acquire(first ? first->sequence() : 0);
+    check(second && second->sequence() == 2 && holds(*second, 32, 2), "second frame isn't acquired as published");
+    check(writer.last_sequence() == 2, "writer's sequence doesn't count frames");
+}
+
+// With three slots, the writer never touches the newest frame's slot nor a pinned one, and has nowhere to
+// write once the two others are pinned.
+static void writer_skips_pinned_slots(const std::string &name) {
+    shm_frame_writer writer{name, 64, 3};
+    shm_frame_reader reader{name};
+
+    const unsigned char *slot_a = publish_frame(writer, 8, 1);
+    auto frame_1 = reader.acquire();
+    const unsigned char *slot_b = publish_frame(writer, 8, 2);
+    auto frame_2 = reader.acquire(1);
+    check(slot_b && slot_b != slot_a, "writer reused the pinned newest slot");
+
+    const unsigned char *slot_c = publish_frame(writer, 8, 3);
+    check(slot_c && slot_c != slot_a && slot_c != slot_b, "writer reused a pinned slot");
+    check(frame_1 && holds(*frame_1, 8, 1) && frame_2 && holds(*frame_2, 8, 2), "a pinned frame was overwritten");
+
+    auto frame_3 = reader.acquire(2);
+    check(frame_3 && frame_3->sequence() == 3, "third frame isn't acquired");
+    check(writer.begin_frame(8) == nullptr, "begin_frame claims a slot while every other slot is pinned");
+
+    frame_1.reset();
+    check(writer.begin_frame(8) == slot_a, "a released slot isn't reused");
+    writer.cancel();
+}
+
+// Growing replaces the segment under the same name; a reader holding a frame from the old one can still read
+// it, and its next acquire reconnects to the new one.
+static void reader_follows_growth(const std::string &name) {
+    shm_frame_writer writer{name, 64};
+    shm_frame_reader reader{name};
+
+    publish_frame(writer, 64, 4);
+    auto small = reader.acquire();
+    check(small && holds(*small, 64, 4), "frame before growth isn't acquired");
+
+    publish_frame(writer, 4096, 5);
+    check(writer.capacity() >= 4096, "writer didn't grow");
+    auto large = reader.acquire(small ? small->sequence() : 0);
+    check(large && large->sequence() == 2 && holds(*large, 4096, 5), "reader didn't reconnect after growth");
+    check(small && holds(*small, 64, 4), "frame from the old segment changed under its reader");
+
+    shm_frame_reader late{name};
+    auto latest = late.acquire();
+    check(latest && latest->sequence() == 2, "a new reader doesn't open the grown segment");
+}
+
+static void second_writer_is_refused(const std::string &name) {
+    shm_frame_writer writer{name, 64};
+    try {
+        shm_frame_writer second{name, 64};
+        check(false, "a second writer took over a live writer's name");
+    } catch (const std::system_error &e) {
+        check(e.code().value() == EEXIST, "a second writer fails with something other than EEXIST");
+    }
+}
+
+// A writer that exits without unlinking its name leaves the segment behind; the next writer takes it over.
+static void dead_writer_is_replaced(const std::string &name) {
+    const pid_t child = fork();
+    if (child == 0) {
+        shm_frame_writer writer{name, 64};
+        publish_frame(writer, 8, 6);
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    try {
+        shm_frame_writer writer{name, 64};
+        shm_frame_reader reader{name};
+        check(!reader.acquire(), "the dead writer's frame survives the takeover");
+    } catch (const std::system_error &) {
+        check(false, "a dead writer's segment isn't taken over");
+    }
+}
+
+int main() {
+    const std::string name = "/mxu_test_" + std::to_string(getpid());
+    publish_then_acquire(name);
+    writer_skips_pinned_slots(name);
+    reader_follows_growth(name);
+    second_writer_is_refused(name);
+    dead_writer_is_replaced(name);
+    check(!shm_segment::open(name), "the writer's name outlives it");
+    if (failures == 0) {
+        std::printf("all shm_frame checks passed\n");
+    }
+    return failures == 0 ? 0 : 1;
+}